@@ -0,0 +1,216 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+#include "houdini/util/perf_counters.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+enum BenchEvents : houdini::JEvent {
+    toggle,
+    guarded
+};
+
+JANUS_CREATE_EVENT(BenchEvents, bevent);
+
+struct Off : houdini::State<> {};
+struct On : houdini::State<> {};
+
+struct Pass {
+    template <typename Context, typename Broker>
+    bool operator()(houdini::JEvent, Context&, Broker&) const {
+        return true;
+    }
+};
+
+struct BenchRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Off> + bevent<toggle> = state<On>,
+             state<On>  + bevent<toggle> = state<Off>,
+             state<Off> + bevent<guarded>[Pass{}] = state<On>,
+             state<On>  + bevent<guarded>[Pass{}] = state<Off>
+        );
+        //clang-format on
+    }
+};
+
+/** 
+ * @brief Report hardware counters per iteration alongside the timings, when the machine provides them. 
+ */
+class CounterReport {
+    public:
+        explicit CounterReport(benchmark::State& state_) : state(state_) {
+            this->group.read(this->start);
+        }
+
+        ~CounterReport(){
+            houdini::util::PerfSample end;
+            if (!this->group.read(end)){
+                return;
+            }
+            const auto delta = end - this->start;
+            const auto rate = benchmark::Counter::kAvgIterations;
+            this->state.counters["cycles"] = benchmark::Counter(static_cast<double>(delta.cycles), rate);
+            this->state.counters["instructions"] = benchmark::Counter(static_cast<double>(delta.instructions), rate);
+            this->state.counters["cache_misses"] = benchmark::Counter(static_cast<double>(delta.cache_misses), rate);
+            this->state.counters["branch_misses"] = benchmark::Counter(static_cast<double>(delta.branch_misses), rate);
+        }
+
+    private:
+        benchmark::State& state;
+        houdini::util::PerfCounterGroup group;
+        houdini::util::PerfSample start;
+};
+
+template <BenchEvents Event>
+void BM_ProcessEvent(benchmark::State& state){
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    houdini::SM<BenchRoot, BenchEvents> state_machine(context, broker);
+
+    CounterReport report(state);
+    for (auto _ : state){
+        benchmark::DoNotOptimize(state_machine.processEvent(Event));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ProcessEvent, toggle);
+BENCHMARK_TEMPLATE(BM_ProcessEvent, guarded);
+
+//copy a state machine, run an event on the copy and throw it away
+void BM_CopyAndProcessEvent(benchmark::State& state){
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    houdini::SM<BenchRoot, BenchEvents> state_machine(context, broker);
+
+    CounterReport report(state);
+    for (auto _ : state){
+        houdini::SM<BenchRoot, BenchEvents> copy(state_machine);
+        benchmark::DoNotOptimize(copy.processEvent(toggle));
+    }
+}
+
+BENCHMARK(BM_CopyAndProcessEvent);
+
+enum WcetEvents : houdini::JEvent {
+    start,
+    fault
+};
+
+JANUS_CREATE_EVENT(WcetEvents, wevent);
+
+struct Fail {
+    template <typename Context, typename Broker>
+    bool operator()(houdini::JEvent, Context&, Broker&) const {
+        return false;
+    }
+};
+
+struct Record {
+    template <typename Context, typename Broker>
+    void operator()(houdini::JEvent, Context&, Broker&) const {
+        benchmark::ClobberMemory();
+    }
+};
+
+struct Idle : houdini::State<> {};
+struct Inner : houdini::State<> {};
+struct Draining : houdini::State<> {};
+struct Settling : houdini::State<> {};
+
+struct Outer : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        using namespace houdini;
+        return transition_table(*state<Inner> + wevent<start> = state<Inner>);
+    }
+};
+
+struct Active : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        using namespace houdini;
+        return transition_table(*state<Outer> + wevent<start> = state<Outer>);
+    }
+};
+
+//every guard of the fault event fails but the last, and the fault is followed by a chain of anonymous transitions
+struct WcetRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Idle>     + wevent<start>                    = state<Active>,
+             state<Active>   + wevent<fault>[Fail{}]            = state<Idle>,
+             state<Active>   + wevent<fault>[Fail{}]            = state<Idle>,
+             state<Active>   + wevent<fault>[Pass{}] / Record{} = state<Draining>,
+             state<Draining>                                    = state<Settling>,
+             state<Settling> [Pass{}]                           = state<Idle>
+        );
+        //clang-format on
+    }
+};
+
+struct Closed : houdini::State<> {};
+struct Open : houdini::State<> {};
+struct Flushing : houdini::State<> {};
+
+//the toggle transitions lead to states without anonymous transitions, while another part of the machine has a chain of them
+struct GateRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Closed>   + bevent<toggle>   = state<Open>,
+             state<Open>     + bevent<toggle>   = state<Closed>,
+             state<Open>     + bevent<guarded>  = state<Flushing>,
+             state<Flushing>                    = state<Idle>,
+             state<Idle>                        = state<Closed>
+        );
+        //clang-format on
+    }
+};
+
+template <BenchEvents Event>
+void BM_ProcessEventWithCompletions(benchmark::State& state){
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    houdini::SM<GateRoot, BenchEvents> state_machine(context, broker);
+
+    CounterReport report(state);
+    for (auto _ : state){
+        benchmark::DoNotOptimize(state_machine.processEvent(Event));
+        if constexpr (Event == guarded){
+            //back from Closed, the end of the chain
+            state_machine.processEvent(toggle);
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ProcessEventWithCompletions, toggle);
+BENCHMARK_TEMPLATE(BM_ProcessEventWithCompletions, guarded);
+
+//start each iteration from the worst state found at compile time, and process the worst event from there
+void BM_WorstCaseEvent(benchmark::State& state){
+    using WcetSM = houdini::SM<WcetRoot, WcetEvents>;
+    constexpr houdini::sm::ExecutionBounds bounds = WcetSM::execution_bounds;
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    WcetSM state_machine(context, broker);
+
+    CounterReport report(state);
+    for (auto _ : state){
+        state_machine.activate(bounds.worst_state);
+        benchmark::DoNotOptimize(state_machine.processEvent(static_cast<WcetEvents>(bounds.worst_event)));
+    }
+    state.counters["max_exits"] = static_cast<double>(bounds.exits);
+    state.counters["max_entries"] = static_cast<double>(bounds.entries);
+    state.counters["max_guards"] = static_cast<double>(bounds.guards);
+    state.counters["max_actions"] = static_cast<double>(bounds.actions);
+}
+
+BENCHMARK(BM_WorstCaseEvent);
+
+} //namespace
@@ -0,0 +1,129 @@
+#include "houdini/util/enum_utils.hpp"
+#include "houdini/util/types.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+//commands received as text by a broker, as from a configuration file or a control channel
+enum class Command : houdini::JEvent {
+    start,
+    stop,
+    pause,
+    resume,
+    reset,
+    shutdown,
+    set_temperature,
+    set_pressure,
+    set_flow_rate,
+    open_valve,
+    close_valve,
+    open_vent,
+    close_vent,
+    ignite,
+    extinguish,
+    purge,
+    calibrate,
+    self_test,
+    report_status,
+    report_faults,
+    clear_faults,
+    acknowledge_alarm,
+    silence_alarm,
+    enter_maintenance,
+    leave_maintenance,
+    load_recipe,
+    unload_recipe,
+    begin_batch,
+    end_batch,
+    abort_batch,
+    heartbeat,
+    ping
+};
+
+constexpr auto command_names = houdini::util::enum_names<Command>();
+
+std::optional<Command> parseLinearScan(std::string_view name){
+    for (Command command:houdini::util::enum_values<Command>()){
+        if (houdini::util::enum_name(command) == name){
+            return command;
+        }
+    }
+    return std::nullopt;
+}
+
+//the lookup of enum_name before it used a table indexed by value, kept for comparison
+std::string_view nameChecked(Command command){
+    namespace e = houdini::util::_enum;
+    if (const auto i = e::endex<Command>(command); i != e::invalid_index_v<Command>){
+        return e::names_v<Command>[i];
+    }
+    return {};
+}
+
+//every command in turn, with one unknown command out of 8
+template <typename Parse>
+void parseCommands(benchmark::State& state, Parse&& parse){
+    std::array<std::string_view, command_names.size() + command_names.size() / 7> inputs{};
+    for (std::size_t i = 0, name = 0; i < inputs.size(); i++){
+        inputs[i] = i % 8 == 7 ? std::string_view{"set_temperatures"} : command_names[name++];
+    }
+    std::size_t i = 0;
+    for (auto _ : state){
+        benchmark::DoNotOptimize(parse(inputs[i]));
+        i = i + 1 < inputs.size() ? i + 1 : 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ParseLinearScan(benchmark::State& state){
+    parseCommands(state, [](std::string_view name){ return parseLinearScan(name); });
+}
+
+void BM_ParseUnorderedMap(benchmark::State& state){
+    std::unordered_map<std::string_view, Command> commands;
+    for (Command command:houdini::util::enum_values<Command>()){
+        commands.emplace(houdini::util::enum_name(command), command);
+    }
+    parseCommands(state, [&commands](std::string_view name) -> std::optional<Command> {
+        if (auto it = commands.find(name); it != commands.end()){
+            return it->second;
+        }
+        return std::nullopt;
+    });
+}
+
+void BM_ParsePerfectHash(benchmark::State& state){
+    parseCommands(state, [](std::string_view name){ return houdini::util::enum_from_str<Command>(name); });
+}
+
+template <typename Name>
+void nameCommands(benchmark::State& state, Name&& name){
+    std::size_t value = 0;
+    for (auto _ : state){
+        benchmark::DoNotOptimize(name(static_cast<Command>(value)));
+        value = value + 1 < command_names.size() ? value + 1 : 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_EnumNameChecked(benchmark::State& state){
+    nameCommands(state, [](Command command){ return nameChecked(command); });
+}
+
+void BM_EnumNameTable(benchmark::State& state){
+    nameCommands(state, [](Command command){ return houdini::util::enum_name(command); });
+}
+
+} //namespace
+
+BENCHMARK(BM_ParseLinearScan);
+BENCHMARK(BM_ParseUnorderedMap);
+BENCHMARK(BM_ParsePerfectHash);
+BENCHMARK(BM_EnumNameChecked);
+BENCHMARK(BM_EnumNameTable);
@@ -0,0 +1,27 @@
+# Time the compilation of each of SOURCES, REPEAT times, and report the fastest.
+# Run with cmake -DCOMPILER=<c++ compiler> -DINCLUDE_DIR=<houdini include directory> -DSOURCES=<a;b> [-DREPEAT=<n>] -P measure_compile_time.cmake
+if(NOT REPEAT)
+    set(REPEAT 3)
+endif()
+
+foreach(source IN LISTS SOURCES)
+    set(best "")
+    foreach(run RANGE 1 ${REPEAT})
+        string(TIMESTAMP start "%s%f")
+        execute_process(
+            COMMAND ${COMPILER} -std=c++17 -fsyntax-only -I${INCLUDE_DIR} ${source}
+            RESULT_VARIABLE result
+            ERROR_VARIABLE errors
+        )
+        string(TIMESTAMP end "%s%f")
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "Failed to compile ${source}:\n${errors}")
+        endif()
+        math(EXPR elapsed "(${end} - ${start}) / 1000")
+        if(best STREQUAL "" OR elapsed LESS best)
+            set(best ${elapsed})
+        endif()
+    endforeach()
+    get_filename_component(name ${source} NAME_WE)
+    message("${name}: ${best} ms")
+endforeach()
@@ -0,0 +1,133 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/sm/backend/event_journal.hpp"
+#include "houdini/sm/backend/event_replay.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+enum JournalEvents : houdini::JEvent {
+    toggle
+};
+
+JANUS_CREATE_EVENT(JournalEvents, jevent);
+
+struct Off : houdini::State<> {};
+struct On : houdini::State<> {};
+
+struct JournalRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Off> + jevent<toggle> = state<On>,
+             state<On>  + jevent<toggle> = state<Off>
+        );
+        //clang-format on
+    }
+};
+
+using JournalSM = houdini::SM<JournalRoot, JournalEvents>;
+
+const std::string journal_path = "journal_benchmark.log";
+
+void removeJournal(){
+    std::remove(journal_path.c_str());
+    std::remove((journal_path + ".checkpoint").c_str());
+}
+
+void BM_ProcessEventUnjournaled(benchmark::State& state){
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    JournalSM state_machine(context, broker);
+
+    for (auto _ : state){
+        benchmark::DoNotOptimize(state_machine.processEvent(toggle));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+//group commits of at most `commit_bytes`, or 1ms of events
+void BM_ProcessEventJournaled(benchmark::State& state){
+    removeJournal();
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    JournalSM state_machine(context, broker);
+    houdini::sm::JournalOptions options;
+    options.capacity = std::size_t{1} << 26;
+    options.commit_bytes = static_cast<std::size_t>(state.range(0));
+    houdini::sm::EventJournal journal(journal_path, JournalSM::LAYOUT_HASH, options);
+    houdini::sm::JournaledSM<JournalSM> journaled(state_machine, journal, 1000000);
+
+    for (auto _ : state){
+        benchmark::DoNotOptimize(journaled.processEvent(toggle));
+    }
+    state.SetItemsProcessed(state.iterations());
+    removeJournal();
+}
+
+//recovery of a state machine from a journal of `range(0)` events, without checkpoint
+void BM_Recover(benchmark::State& state){
+    removeJournal();
+    const auto length = static_cast<std::size_t>(state.range(0));
+    {
+        houdini::sm::JournalOptions options;
+        options.capacity = (length + 1) * sizeof(houdini::sm::JournalRecord) + sizeof(houdini::sm::JournalHeader);
+        houdini::sm::EventJournal journal(journal_path, JournalSM::LAYOUT_HASH, options);
+        for (std::size_t i = 0; i < length; i++){
+            journal.append(toggle, nullptr, 0);
+        }
+    }
+
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    for (auto _ : state){
+        JournalSM state_machine(context, broker);
+        houdini::sm::EventJournal journal(journal_path, JournalSM::LAYOUT_HASH);
+        houdini::sm::JournaledSM<JournalSM> journaled(state_machine, journal);
+        benchmark::DoNotOptimize(journaled.recover());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    removeJournal();
+}
+
+//replay of 16 recorded streams of 1M events over a pool of `range(0)` threads
+void BM_ReplayInParallel(benchmark::State& state){
+    removeJournal();
+    constexpr std::size_t length = 1000000;
+    {
+        houdini::sm::JournalOptions options;
+        options.capacity = (length + 1) * sizeof(houdini::sm::JournalRecord) + sizeof(houdini::sm::JournalHeader);
+        houdini::sm::EventJournal journal(journal_path, JournalSM::LAYOUT_HASH, options);
+        for (std::size_t i = 0; i < length; i++){
+            journal.append(toggle, nullptr, 0);
+        }
+    }
+
+    houdini::sm::ReplayStream stream(journal_path, JournalSM::LAYOUT_HASH);
+    double per_thread = 0;
+    for (auto _ : state){
+        const auto stats = houdini::sm::replayInParallel(16, static_cast<std::size_t>(state.range(0)), [&stream](std::size_t){
+            houdini::act::BaseContext context;
+            houdini::brokers::BaseBroker broker;
+            JournalSM state_machine(context, broker);
+            return houdini::sm::replay(state_machine, stream);
+        });
+        per_thread = stats.eventsPerSecondPerThread();
+    }
+    state.counters["events_per_second_per_thread"] = per_thread;
+    state.SetItemsProcessed(state.iterations() * 16 * static_cast<std::int64_t>(length));
+    removeJournal();
+}
+
+BENCHMARK(BM_ProcessEventUnjournaled);
+BENCHMARK(BM_ProcessEventJournaled)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_Recover)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReplayInParallel)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} //namespace
@@ -0,0 +1,69 @@
+#include "houdini/util/timing_wheel.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+namespace {
+
+using houdini::TimePoint;
+using houdini::util::TimerNode;
+using houdini::util::TimingWheel;
+
+void countExpiry(TimerNode& node){
+    (*static_cast<std::size_t*>(node.context))++;
+}
+
+//arm and cancel one timer while `state.range(0)` others are armed, as when a state with a timeout is entered and left
+void BM_ArmAndCancelTimer(benchmark::State& state){
+    const auto num_timers = static_cast<std::size_t>(state.range(0));
+    TimingWheel wheel;
+    wheel.advance(TimePoint{});
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> delay(1, 60000);
+    auto timers = std::make_unique<TimerNode[]>(num_timers);
+    for (std::size_t i = 0; i < num_timers; i++){
+        wheel.arm(timers[i], std::chrono::milliseconds(delay(generator)));
+    }
+
+    TimerNode timer;
+    for (auto _ : state){
+        wheel.arm(timer, std::chrono::milliseconds(200));
+        wheel.cancel(timer);
+    }
+    state.counters["armed"] = static_cast<double>(wheel.size());
+}
+
+BENCHMARK(BM_ArmAndCancelTimer)->Arg(1000)->Arg(100000);
+
+//expire `state.range(0)` timers spread over one minute, advancing the wheel every millisecond
+void BM_ExpireTimers(benchmark::State& state){
+    const auto num_timers = static_cast<std::size_t>(state.range(0));
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> delay(1, 60000);
+    auto timers = std::make_unique<TimerNode[]>(num_timers);
+    std::size_t expired = 0;
+    for (std::size_t i = 0; i < num_timers; i++){
+        timers[i].callback = &countExpiry;
+        timers[i].context = &expired;
+    }
+
+    for (auto _ : state){
+        TimingWheel wheel;
+        wheel.advance(TimePoint{});
+        for (std::size_t i = 0; i < num_timers; i++){
+            wheel.arm(timers[i], std::chrono::milliseconds(delay(generator)));
+        }
+        for (int ms = 1; ms <= 60000; ms++){
+            wheel.advance(TimePoint{} + std::chrono::milliseconds(ms));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(expired));
+}
+
+BENCHMARK(BM_ExpireTimers)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+} //namespace
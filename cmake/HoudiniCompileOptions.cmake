@@ -2,4 +2,9 @@
 option(ENABLE_BENCHMARKS "Build run time and compile time benchmarks" OFF)
 option(ENABLE_EXAMPLES "Build sample houdini code" OFF)
 option(DISABLE_RTTI "Disable run-time type information" OFF)
-option(DISABLE_EXCEPTIONS "Disable run-time exceptions" OFF)
\ No newline at end of file
+option(DISABLE_EXCEPTIONS "Disable run-time exceptions" OFF)
+option(ENABLE_GUARD_PROFILING "Count how often each transition guard passes, so a guard profile can be generated" OFF)
+option(ENABLE_TRACING "Record every state machine transition into a per state machine trace ring" OFF)
+option(ENABLE_METRICS "Keep latency histograms of every transition and state hook" OFF)
+option(ENABLE_PERF_COUNTERS "Collect hardware performance counters for every dispatch and update hook (Linux only; implies ENABLE_METRICS)" OFF)
+option(ENABLE_STATIC_QUEUES "Use fixed-capacity event queues so state machines and actors do not allocate after construction" OFF)
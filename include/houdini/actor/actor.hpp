@@ -1,26 +1,42 @@
 #pragma once
 #include "houdini/actor/context.hpp"
 #include "houdini/sm/sm.hpp"
+#include "houdini/sm/backend/event_journal.hpp"
+#include "houdini/sm/backend/event_replay.hpp"
 #include "houdini/brokers/message_broker.hpp"
 #include "houdini/util/types.hpp"
 #include "houdini/util/enum_utils.hpp"
+#include "houdini/util/mp11.hpp"
 #include "houdini/util/type_name.hpp"
+#include "houdini/util/timing_wheel.hpp"
 
+#include <condition_variable>
 #include <memory_resource>
 #include <ratio>
 #include <string_view>
 #include <mutex>
+#include <optional>
 #include <utility>
 #include <cstddef>
 #include <thread>
 #include <chrono>
 #include <cassert>
 #include <atomic>
+#include <algorithm>
 #include <type_traits>
 
 namespace houdini {
 namespace act {
 
+namespace detail {
+template <class Broker>
+using HasGeneratorsImpl = decltype(std::declval<Broker&>().pollGenerators(TimePoint{}));
+
+//brokers that do not derive from `MessageBroker` may not run generators
+template <class Broker>
+using HasGenerators = mp::mp_valid<HasGeneratorsImpl, Broker>;
+} //namespace detail
+
 template <
         class Events, 
         class RootState,        
@@ -32,29 +48,89 @@ class BaseActor {
         BaseActor(const BaseActor&) = delete;
         BaseActor(BaseActor&&) = delete;
 
+        /**
+         * @brief All memory used by the actor (its state machine, states, behaviors, 
+         * dispatch table and queues) is allocated from `resource_ptr`.
+         */
         template <typename... BrokerArgs>
-        explicit BaseActor(Context context, BrokerArgs&... args): //create a copy of the context to ensure encapsulation
+        explicit BaseActor(Context context, std::pmr::memory_resource* resource_ptr, BrokerArgs&... args): //create a copy of the context to ensure encapsulation
+        alloc(resource_ptr),
         execution_context(context),
-        message_broker{util::type_name<RootState>(), &cv, args...}
-        {}
+        message_broker(makeBroker(args...)),
+        actor_sm(std::allocator_arg, alloc, execution_context, message_broker)
+        {
+            this->actor_sm.attachTimers(this->timing_wheel);
+        }
 
         using StateMachine = SM<RootState,Events,Context,MessageBroker>;
+
+        /**
+         * @brief Recover the state of the state machine from `journal`, then journal every event processed 
+         * by the actor to it, with a checkpoint every `checkpoint_interval` events. Must be called before the actor runs.
+         * 
+         * @return the number of events replayed, or nothing if the journal could not be used, in which case
+         * events are not journaled.
+         */
+        std::optional<std::size_t> journalTo(sm::EventJournal& journal, std::size_t checkpoint_interval = 100000){
+            this->journaled_sm.emplace(this->actor_sm, journal, checkpoint_interval);
+            auto replayed = this->journaled_sm->recover();
+            if (!replayed){
+                this->journaled_sm.reset();
+            }
+            return replayed;
+        }
     
     protected:
+        template <typename... BrokerArgs>
+        MessageBroker makeBroker(BrokerArgs&... args){
+            if constexpr (std::is_constructible_v<MessageBroker, 
+                std::string_view, std::condition_variable*, const JAllocator<std::byte>&, BrokerArgs&...>){
+                return MessageBroker(util::type_name<RootState>(), &this->cv, this->alloc, args...);
+            } else {
+                return MessageBroker{util::type_name<RootState>(), &this->cv, args...};
+            }
+        }
         
         SMResult processEvent(Events event){
             assert(util::enum_value_valid(event));
+            if (this->journaled_sm){
+                return this->journaled_sm->processEvent(event);
+            }
             return this->actor_sm.processEvent(event);
         }
 
+        void pollGenerators(TimePoint now){
+            if constexpr (detail::HasGenerators<MessageBroker>::value){
+                this->message_broker.pollGenerators(now);
+            }
+        }
+
+        TimePoint nextGeneratorDue(){
+            if constexpr (detail::HasGenerators<MessageBroker>::value){
+                return this->message_broker.nextGeneratorDue();
+            } else {
+                return TimePoint::max();
+            }
+        }
+
+        void commitJournal(){
+            if (this->journaled_sm){
+                this->journaled_sm->commit();
+            }
+        }
+
         void processEvent(JEvent event_id){
             Events event = static_cast<Events>(event_id);
             return this->processEvent(event);
         }
 
+        JAllocator<std::byte> alloc; 
         Context execution_context{}; 
         MessageBroker message_broker;
-        StateMachine actor_sm = StateMachine(execution_context, message_broker);
+        //timers of the `after` and `every` transitions of the state machine, which must outlive it
+        util::TimingWheel timing_wheel;
+        StateMachine actor_sm;
+        std::optional<sm::JournaledSM<StateMachine>> journaled_sm;
         std::mutex context_mutex{};
         std::condition_variable cv{};
 };
@@ -86,9 +162,8 @@ class Actor : public BaseActor<Events, RootState, Context, MessageBroker> {
             std::chrono::milliseconds update_freq = std::chrono::milliseconds(50), 
             std::pmr::memory_resource* resource_ptr = std::pmr::new_delete_resource(),
             BrokerArgs&... args): 
-            update_time(update_freq),
-            mem_resource_ptr(resource_ptr),
-            BaseActor<Events, RootState, Context, MessageBroker>(context, args...){
+            BaseActor<Events, RootState, Context, MessageBroker>(context, resource_ptr, args...),
+            update_time(update_freq){
             
             this->execution_context.actor_status = ActorStatus::IDLE;
         }
@@ -144,6 +219,7 @@ class Actor : public BaseActor<Events, RootState, Context, MessageBroker> {
             while (this->execution_context.actor_status != ActorStatus::STOP){
                 unique_lock.lock();
                 this->cv.wait(unique_lock, [this](){return this->message_broker.hasEvents();});
+                this->timing_wheel.advance(SteadyClock::now());
                 Events event = this->message_broker.getFirstEvent();
                 [[maybe_unused]] SMResult result = this->processEvent(event);
                 if (this->execution_context.stop_flag){
@@ -161,7 +237,57 @@ class Actor : public BaseActor<Events, RootState, Context, MessageBroker> {
         }
 
         ActorStatus status() const {
-            return this->execution_context.status;
+            return this->execution_context.actor_status;
+        }
+
+        /**
+         * @brief Perform one iteration of the actor's work on the calling thread as of time `now`: 
+         * take the transitions of the timers that expired, run the broker's event generators, process all 
+         * queued events, then update the state machine if an update is due. 
+         * 
+         * @par This is how actors are driven by a `SimulationExecutor`. It must not be called while `run()` is active.
+         * @return the time at which the actor next has work to do.
+         */
+        TimePoint step(TimePoint now){
+            this->timing_wheel.advance(now);
+            this->pollGenerators(now);
+            while (this->message_broker.hasEvents() && this->execution_context.actor_status != ActorStatus::STOP){
+                [[maybe_unused]] SMResult result = this->processEvent(this->message_broker.getFirstEvent());
+                if (this->execution_context.stop_flag){
+                    this->execution_context.actor_status = ActorStatus::STOP;
+                }
+            }
+            this->commitJournal();
+            if (this->execution_context.actor_status != ActorStatus::STOP && now >= this->next_update_time){
+                this->actor_sm.update(now);
+                this->next_update_time = now + this->update_time;
+            }
+            return this->nextDue();
+        }
+
+        /**
+         * @brief Process all events of a recorded `stream` on the calling thread, as fast as possible, bypassing 
+         * the message broker. `observer` is called after each event, as in `sm::replay`.
+         * 
+         * @par It must not be called while `run()` is active.
+         */
+        template <class Observer>
+        sm::ReplayStats replay(const sm::ReplayStream& stream, Observer&& observer){
+            return sm::replay(this->actor_sm, stream, std::forward<Observer>(observer));
+        }
+
+        /**
+         * @brief The time at which `step` next has work to do, which is the next update, timer or event generator.
+         * `TimePoint::min()` if events are waiting, `TimePoint::max()` if the actor has stopped. 
+         */
+        TimePoint nextDue() {
+            if (this->execution_context.actor_status == ActorStatus::STOP){
+                return TimePoint::max();
+            }
+            if (this->message_broker.hasEvents()){
+                return TimePoint::min();
+            }
+            return std::min({this->next_update_time, this->timing_wheel.nextDue(), this->nextGeneratorDue()});
         }
 
     private:
@@ -170,11 +296,15 @@ class Actor : public BaseActor<Events, RootState, Context, MessageBroker> {
             //this is a crude and likely unnecessary lock, but ensures no race conditions 
             //in the system. 
             auto lock = std::lock_guard(this->context_mutex);
+            this->pollGenerators(SteadyClock::now());
             this->message_broker.loopOnce();
         }
 
         void updateCallback(){
             auto lock = std::lock_guard(this->context_mutex);
+            //when run on its own threads, timers expire with the granularity of the update period
+            this->timing_wheel.advance(SteadyClock::now());
+            this->commitJournal();
             this->actor_sm.update();
         }
         
@@ -185,10 +315,9 @@ class Actor : public BaseActor<Events, RootState, Context, MessageBroker> {
             std::this_thread::sleep_until(this->current_time + this->update_time);
         }
 
-        std::pmr::memory_resource* mem_resource_ptr = std::pmr::new_delete_resource();
-        JAllocator<std::byte> alloc = JAllocator<std::byte>{mem_resource_ptr};
         std::chrono::time_point<std::chrono::steady_clock> current_time;
         const std::chrono::milliseconds update_time = std::chrono::milliseconds(50);
+        TimePoint next_update_time = TimePoint::min();
         
         std::thread update_thread;
         std::thread broker_thread;    
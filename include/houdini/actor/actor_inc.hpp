@@ -2,11 +2,14 @@
 #include "houdini/actor/actor.hpp"
 #include "houdini/actor/context.hpp"
 #include "houdini/actor/driver_client.hpp"
+#include "houdini/actor/simulation_executor.hpp"
 
 namespace houdini {
 
     using act::Actor;
     using act::Context;
     using act::DriverClient;
+    using act::SimulationExecutor;
+    using act::VirtualClock;
 
 } //namespace houdini
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+#include "houdini/util/types.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+
+namespace houdini {
+namespace act {
+
+/**
+ * @brief A clock that only moves when it is told to. Its time points are interchangeable 
+ * with those of `SteadyClock`, so anything that accepts a `TimePoint` can be driven by it.
+ */
+class VirtualClock {
+    public:
+        using duration = SteadyClock::duration;
+        using rep = SteadyClock::rep;
+        using period = SteadyClock::period;
+        using time_point = TimePoint;
+        static constexpr bool is_steady = true;
+
+        explicit VirtualClock(TimePoint start = TimePoint{}) noexcept : current(start) {}
+
+        TimePoint now() const noexcept {
+            return this->current;
+        }
+
+        void advanceTo(TimePoint time) noexcept {
+            assert(time >= this->current && "Virtual time cannot go backwards.");
+            this->current = time;
+        }
+
+        void advanceBy(duration delta) noexcept {
+            this->advanceTo(this->current + delta);
+        }
+
+    private:
+        TimePoint current;
+};
+
+/**
+ * @brief Runs any number of actors deterministically on the calling thread against a `VirtualClock`. 
+ * 
+ * @par Instead of sleeping between iterations, the executor jumps virtual time straight to the earliest 
+ * time at which some actor has work to do (a pending event or an update), and steps every actor that is due 
+ * in the order they were added. Events posted to an actor's broker during a step are processed at the same virtual time. 
+ * 
+ * @par Actors must provide `TimePoint step(TimePoint)` and `TimePoint nextDue()`, as `Actor` does.
+ * Actors are not owned by the executor and must outlive it. Their `run()` method must not be called.
+ */
+class SimulationExecutor {
+    public:
+        explicit SimulationExecutor(
+            TimePoint start = TimePoint{}, 
+            std::pmr::memory_resource* resource_ptr = std::pmr::get_default_resource())
+        : virtual_clock(start), tasks(JAllocator<Task>(resource_ptr)) {}
+
+        SimulationExecutor(const SimulationExecutor&) = delete;
+        SimulationExecutor& operator=(const SimulationExecutor&) = delete;
+
+        template <typename ActorType>
+        void add(ActorType& actor){
+            this->tasks.push_back(Task{
+                &actor,
+                [](void* a, TimePoint now){ return static_cast<ActorType*>(a)->step(now); },
+                [](void* a){ return static_cast<ActorType*>(a)->nextDue(); }
+            });
+        }
+
+        /**
+         * @brief Run all actors until no work remains before `end`. The clock is left at `end`.
+         * @return the number of actor steps performed.
+         */
+        std::size_t runUntil(TimePoint end){
+            std::size_t steps = 0;
+            while (true){
+                TimePoint next = TimePoint::max();
+                for (const Task& task: this->tasks){
+                    next = std::min(next, task.next_due(task.actor));
+                }
+                if (next == TimePoint::max() || next > end){
+                    break;
+                }
+                if (next > this->virtual_clock.now()){
+                    this->virtual_clock.advanceTo(next);
+                }
+
+                const TimePoint now = this->virtual_clock.now();
+                for (const Task& task: this->tasks){
+                    if (task.next_due(task.actor) <= now){
+                        task.step(task.actor, now);
+                        steps++;
+                    }
+                }
+            }
+            if (end > this->virtual_clock.now()){
+                this->virtual_clock.advanceTo(end);
+            }
+            return steps;
+        }
+
+        std::size_t runFor(VirtualClock::duration duration){
+            return this->runUntil(this->virtual_clock.now() + duration);
+        }
+
+        TimePoint now() const noexcept {
+            return this->virtual_clock.now();
+        }
+
+        const VirtualClock& clock() const noexcept {
+            return this->virtual_clock;
+        }
+
+        std::size_t size() const noexcept {
+            return this->tasks.size();
+        }
+
+    private:
+        //actors of different types are erased to a pair of function pointers
+        struct Task {
+            void* actor;
+            TimePoint (*step)(void*, TimePoint);
+            TimePoint (*next_due)(void*);
+        };
+
+        VirtualClock virtual_clock;
+        JVector<Task> tasks;
+};
+
+} //namespace act
+} //namespace houdini
@@ -1,7 +1,14 @@
 #pragma once
+#include "houdini/util/constants.hpp"
 #include "houdini/util/types.hpp"
+#include "houdini/util/static_queue.hpp"
+#include "houdini/util/timing_wheel.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <mutex>
+#include <optional>
 #include <string_view>
 #include <string>
 #include <condition_variable>
@@ -21,22 +28,39 @@ class BaseBroker {
  * Represents an abstraction for receiving messages over a message bus. 
  * Specializations should inherit from this class. 
  * 
- * Right now this class doesn't do anything but this may change in the future
+ * @par The broker can also generate events itself at fixed periods, optionally only when a condition holds, 
+ * for heartbeats and polling. Up to `JANUS_MAX_GENERATORS` generators share one timing wheel: generators with 
+ * the same period are woken up together, and the events they generate are queued as one batch. 
+ * Generators are run by `pollGenerators`, which the actor owning the broker calls.
  */
 template <typename EventEnum>
 class MessageBroker : public BaseBroker {
     public:
     MessageBroker(const std::string_view name_ = "none", std::condition_variable* cv_ = nullptr) : BaseBroker{name_, cv_} {}
 
+    /**
+     * Construct the broker with its event queue allocated from the memory resource of `alloc`.
+     */
+    MessageBroker(const std::string_view name_, std::condition_variable* cv_, const JAllocator<std::byte>& alloc) 
+    : BaseBroker{name_, cv_}, event_queue(JAllocator<EventEnum>(alloc)) {}
+
     virtual ~MessageBroker() = default;
 
     MessageBroker(const MessageBroker&) = delete;
 
-    void queueEvent(EventEnum event) {
+    /**
+     * Add an event to the back of the queue. 
+     * @return false if the queue is full and the event was dropped.
+     */
+    bool queueEvent(EventEnum event) {
+        if (util::is_full(this->event_queue)){
+            return false;
+        }
         this->event_queue.push(event);
-        if (this->event_queue.size() == 1){
+        if (this->event_queue.size() == 1 && this->cv){
             this->cv->notify_one();
         }
+        return true;
     }
 
     EventEnum getFirstEvent() {
@@ -53,8 +77,124 @@ class MessageBroker : public BaseBroker {
         return !this->event_queue.empty();
     }
 
+    /**
+     * Generate `event` every `period`, starting one period after the first call to `pollGenerators`,
+     * or after the call to `addGenerator` if generators are already running. If `condition` is given, 
+     * the event is only generated on the periods for which `condition(condition_context)` returns true.
+     * @return the id of the generator, or nothing if `JANUS_MAX_GENERATORS` generators already exist.
+     */
+    std::optional<std::size_t> addGenerator(EventEnum event, std::chrono::milliseconds period, 
+        bool (*condition)(void*) = nullptr, void* condition_context = nullptr) {
+        std::size_t id = 0;
+        while (id < JANUS_MAX_GENERATORS && this->generators[id].active){
+            id++;
+        }
+        if (id == JANUS_MAX_GENERATORS || period.count() <= 0){
+            return std::nullopt;
+        }
+
+        //join the group of generators with the same period, so that they share a wakeup
+        std::size_t group = 0;
+        while (group < JANUS_MAX_GENERATORS && !(this->generator_groups[group].members && this->generator_groups[group].period == period)){
+            group++;
+        }
+        if (group == JANUS_MAX_GENERATORS){
+            group = 0;
+            while (this->generator_groups[group].members){
+                group++;
+            }
+            GeneratorGroup& new_group = this->generator_groups[group];
+            new_group.period = period;
+            new_group.timer.callback = &MessageBroker::onGeneratorTimer;
+            new_group.timer.context = this;
+            new_group.timer.id = group;
+            this->generator_wheel.arm(new_group.timer, period);
+        }
+        this->generator_groups[group].members++;
+        this->generators[id] = Generator{event, group, condition, condition_context, true};
+        return id;
+    }
+
+    void removeGenerator(std::size_t id) {
+        if (id >= JANUS_MAX_GENERATORS || !this->generators[id].active){
+            return;
+        }
+        Generator& generator = this->generators[id];
+        generator.active = false;
+        GeneratorGroup& group = this->generator_groups[generator.group];
+        if (--group.members == 0){
+            this->generator_wheel.cancel(group.timer);
+        }
+    }
+
+    /**
+     * Run the generators that are due as of time `now`, queueing the events they generate. 
+     * @return the number of events queued.
+     */
+    std::size_t pollGenerators(TimePoint now) {
+        this->generated = 0;
+        this->generator_wheel.advance(now);
+        return this->generated;
+    }
+
+    /** The time at which `pollGenerators` next has work to do, `TimePoint::max()` if there are no generators. */
+    TimePoint nextGeneratorDue() const {
+        return this->generator_wheel.nextDue();
+    }
+
+    /** Number of distinct periods among the generators, each of which is a single timer. */
+    std::size_t generatorGroups() const {
+        return this->generator_wheel.size();
+    }
+
     protected:
+    struct Generator {
+        EventEnum event{};
+        std::size_t group = 0;
+        bool (*condition)(void*) = nullptr;
+        void* condition_context = nullptr;
+        bool active = false;
+    };
+
+    struct GeneratorGroup {
+        util::TimerNode timer;
+        std::chrono::milliseconds period{0};
+        std::size_t members = 0;
+    };
+
+    static void onGeneratorTimer(util::TimerNode& timer) {
+        auto& broker = *static_cast<MessageBroker*>(timer.context);
+        broker.generator_wheel.arm(timer, broker.generator_groups[timer.id].period);
+
+        std::array<EventEnum, JANUS_MAX_GENERATORS> batch;
+        std::size_t count = 0;
+        for (const Generator& generator: broker.generators){
+            if (generator.active && generator.group == timer.id 
+                && (!generator.condition || generator.condition(generator.condition_context))){
+                batch[count++] = generator.event;
+            }
+        }
+        broker.generated += broker.queueEvents(batch.data(), count);
+    }
+
+    /** Add events to the back of the queue, waking up the consumer once for the whole batch. */
+    std::size_t queueEvents(const EventEnum* events, std::size_t count) {
+        const bool was_empty = this->event_queue.empty();
+        std::size_t queued = 0;
+        while (queued < count && !util::is_full(this->event_queue)){
+            this->event_queue.push(events[queued++]);
+        }
+        if (was_empty && queued && this->cv){
+            this->cv->notify_one();
+        }
+        return queued;
+    }
+
     JQueue<EventEnum> event_queue;
+    std::array<Generator, JANUS_MAX_GENERATORS> generators{};
+    std::array<GeneratorGroup, JANUS_MAX_GENERATORS> generator_groups{};
+    util::TimingWheel generator_wheel;
+    std::size_t generated = 0;
     virtual void loopOnce() {}
     virtual void loop() {}
 };
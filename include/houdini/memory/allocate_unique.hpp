@@ -1,18 +1,22 @@
 #pragma once
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 namespace houdini {
 namespace memory {
 namespace detail {
 
 /**
- * Most generic implementation of a deleter that takes a memory allocator 
- * that conforms to std::allocator traits. 
+ * Most generic implementation of a deleter that takes a memory allocator
+ * that conforms to std::allocator traits.
  */
 template <typename Alloc>
 struct AllocDeleter {
-    AllocDeleter(const Alloc& a): a(a) { }
+    AllocDeleter(const Alloc& alloc_): a(alloc_) { }
 
     using pointer = typename std::allocator_traits<Alloc>::pointer;
 
@@ -24,18 +28,55 @@ struct AllocDeleter {
     private:
         Alloc a;
 };
-} //namespace 
+
+/**
+ * Deleter for objects allocated from a `std::pmr::memory_resource`.
+ * The block, size and alignment of the allocated object are recorded when it is created,
+ * so a `unique_ptr` holding this deleter can be converted to a `unique_ptr` to a base class
+ * (with a virtual destructor) and still hand the correct block back to the resource.
+ */
+class ResourceDeleter {
+    public:
+        ResourceDeleter() noexcept = default;
+
+        ResourceDeleter(std::pmr::memory_resource* resource_, void* block_, std::size_t size_, std::size_t alignment_) noexcept
+        : resource(resource_), block(block_), size(size_), alignment(alignment_) {}
+
+        template <typename T>
+        void operator()(T* p) const {
+            std::destroy_at(p);
+            this->resource->deallocate(this->block, this->size, this->alignment);
+        }
+
+        std::pmr::memory_resource* getResource() const noexcept {
+            return this->resource;
+        }
+
+    private:
+        std::pmr::memory_resource* resource = nullptr;
+        void* block = nullptr;
+        std::size_t size = 0;
+        std::size_t alignment = alignof(std::max_align_t);
+};
+} //namespace
+
+/**
+ * `std::unique_ptr` whose memory was obtained from a `std::pmr::memory_resource`.
+ * A pointer to a derived type can be converted to a pointer to its base.
+ */
+template <class T>
+using pmr_unique_ptr = std::unique_ptr<T, detail::ResourceDeleter>;
 
 /**
  * Utility function to create a std::unique_ptr with custom memory allocation.
  * For API consistency with std::allocate_shared.
  */
 template <class T, class Alloc, class... Args>
-inline std::unique_ptr<T> allocate_unique(const Alloc& alloc, Args&&... args) {
+inline std::unique_ptr<T, detail::AllocDeleter<Alloc>> allocate_unique(const Alloc& alloc, Args&&... args) {
     using AT = std::allocator_traits<Alloc>;
-    static_assert(std::is_same_v<typename AT::value_type, std::remove_cv_t<T>>, 
+    static_assert(std::is_same_v<typename AT::value_type, std::remove_cv_t<T>>,
             "Allocator has the wrong value_type");
-    
+
     Alloc a(alloc);
     auto p = AT::allocate(a, 1);
     try {
@@ -48,6 +89,24 @@ inline std::unique_ptr<T> allocate_unique(const Alloc& alloc, Args&&... args) {
     }
 }
 
+/**
+ * Overload of allocate_unique for polymorphic allocators. The value type of the allocator
+ * is irrelevant; the object is allocated directly from the allocator's memory resource.
+ * The returned pointer can be converted to a `pmr_unique_ptr` of any base of T.
+ */
+template <class T, class U, class... Args>
+inline pmr_unique_ptr<T> allocate_unique(const std::pmr::polymorphic_allocator<U>& alloc, Args&&... args) {
+    std::pmr::memory_resource* resource = alloc.resource();
+    void* block = resource->allocate(sizeof(T), alignof(T));
+    try {
+        T* p = ::new (block) T(std::forward<Args>(args)...);
+        return pmr_unique_ptr<T>(p, detail::ResourceDeleter(resource, block, sizeof(T), alignof(T)));
+    } catch (...) {
+        resource->deallocate(block, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
 
-} // namespace memory 
-} // namespace houdini 
\ No newline at end of file
+} // namespace memory
+} // namespace houdini
@@ -0,0 +1,51 @@
+#pragma once
+#include <memory_resource>
+
+namespace houdini {
+namespace memory {
+namespace detail {
+
+inline std::pmr::memory_resource*& scopedResourceSlot() noexcept {
+    thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+
+} //namespace detail
+
+/**
+ * @brief Returns the memory resource installed by the innermost active `ResourceScope`
+ * on this thread, or `std::pmr::get_default_resource()` if there is none.
+ *
+ * @par Objects that are default constructed by the framework (states, for example) cannot receive
+ * an allocator through their constructor. They pick up their memory resource from here instead.
+ */
+inline std::pmr::memory_resource* scoped_resource() noexcept {
+    std::pmr::memory_resource* resource = detail::scopedResourceSlot();
+    return resource ? resource : std::pmr::get_default_resource();
+}
+
+/**
+ * @brief RAII guard that installs a memory resource for `scoped_resource()` on the current thread
+ * for its lifetime. Unlike `std::pmr::set_default_resource`, the change is thread-local
+ * and is undone when the guard goes out of scope. Scopes may be nested.
+ */
+class ResourceScope {
+    public:
+        explicit ResourceScope(std::pmr::memory_resource* resource) noexcept
+        : previous(detail::scopedResourceSlot()) {
+            detail::scopedResourceSlot() = resource;
+        }
+
+        ResourceScope(const ResourceScope&) = delete;
+        ResourceScope& operator=(const ResourceScope&) = delete;
+
+        ~ResourceScope(){
+            detail::scopedResourceSlot() = this->previous;
+        }
+
+    private:
+        std::pmr::memory_resource* previous;
+};
+
+} //namespace memory
+} //namespace houdini
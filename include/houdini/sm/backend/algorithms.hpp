@@ -59,11 +59,12 @@ template <class StateList, std::size_t MaxDepth>
 constexpr std::array<std::string_view, MaxDepth> get_state_names(){
 	constexpr std::size_t list_size = mp::mp_size<StateList>::value;
 	static_assert(list_size <= MaxDepth, "Length of state list is longer than max depth of state machine");
-	std::array<std::string_view, MaxDepth> arr;
+	std::array<std::string_view, MaxDepth> arr{};
 	
 	for_each_index_mp<StateList>(
 		[&arr](auto state, std::size_t index){
-			arr[index] = util::type_name(state);
+			//all state types are wrapped in TState<>
+			arr[index] = util::type_name<typename decltype(state)::type>();
 		}
 	);
 
@@ -72,11 +73,11 @@ constexpr std::array<std::string_view, MaxDepth> get_state_names(){
 
 namespace detail {
 template <class StateList, class StateMap, std::size_t MaxIndex, std::size_t MaxDepth>
-constexpr StaticStack<StateIndex, MaxDepth> get_state_indices_impl(StaticStack<StateIndex, MaxDepth>& stack){
+constexpr StaticStack<NarrowStateIndex<MaxIndex>, MaxDepth> get_state_indices_impl(StaticStack<NarrowStateIndex<MaxIndex>, MaxDepth>& stack){
 	if constexpr (mp::mp_empty<StateList>::value){
 		return stack; 
 	} else {
-		StateIndex value = mp::mp_find<StateMap, StateList>::value;
+		auto value = static_cast<NarrowStateIndex<MaxIndex>>(mp::mp_find<StateMap, StateList>::value);
 		//std::cout << "Value found: " << value << std::endl;
 		assert(value < MaxIndex && "StateList not found in StateMap");
 		stack.push_front(std::move(value));
@@ -87,10 +88,10 @@ constexpr StaticStack<StateIndex, MaxDepth> get_state_indices_impl(StaticStack<S
 } //namespace detail
 
 template <class StateList, class StateMap, std::size_t MaxIndex, std::size_t MaxDepth>
-constexpr StaticStack<StateIndex, MaxDepth> get_state_indices(){
+constexpr StaticStack<NarrowStateIndex<MaxIndex>, MaxDepth> get_state_indices(){
 	constexpr std::size_t list_size = mp::mp_size<StateList>::value;
 	static_assert(list_size <= MaxDepth, "Length of state list is longer than max depth of state machine");
-	StaticStack<StateIndex, MaxDepth> stack;
+	StaticStack<NarrowStateIndex<MaxIndex>, MaxDepth> stack;
 	//std::cout << util::type_name<StateList>() << std::endl;
 
 	return detail::get_state_indices_impl<StateList, StateMap, MaxIndex, MaxDepth>(stack);
@@ -0,0 +1,121 @@
+#pragma once
+#include "houdini/sm/backend/execution_bounds.hpp"
+#include "houdini/sm/backend/index.hpp"
+
+#include "houdini/util/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace houdini {
+namespace sm {
+
+/** @brief Whether each state has anonymous transitions, of its own or inherited from one of its parents. */
+template <std::size_t NumStates, std::size_t NumTransitions>
+constexpr std::array<bool, NumStates> make_completion_states(
+	const std::array<StateIndex, NumStates>& parents,
+	const std::array<TransitionFootprint, NumTransitions>& transitions,
+	JEvent no_event_value){
+	std::array<bool, NumStates> completion{};
+	for (StateIndex state = 0; state < NumStates; state++){
+		for (const TransitionFootprint& transition:transitions){
+			if (transition.event == no_event_value && (transition.source == state
+				|| (!transition.internal && detail::isAncestorOrSelf(parents, transition.source, state)))){
+				completion[state] = true;
+			}
+		}
+	}
+	return completion;
+}
+
+namespace detail {
+/**
+ * @brief Target of the anonymous transition always taken from `state`, or `NumStates` if there is none:
+ * the transition must be the only one of the dispatch table cell, without guard, action or history.
+ */
+template <std::size_t NumStates, std::size_t NumTransitions>
+constexpr StateIndex unconditionalCompletion(
+	const std::array<StateIndex, NumStates>& parents,
+	const std::array<TransitionFootprint, NumTransitions>& transitions,
+	JEvent no_event_value,
+	StateIndex state){
+	StateIndex target = NumStates;
+	std::size_t count = 0;
+	for (const TransitionFootprint& transition:transitions){
+		if (transition.event == no_event_value && (transition.source == state
+			|| (!transition.internal && isAncestorOrSelf(parents, transition.source, state)))){
+			count++;
+			const bool unconditional = !transition.guard && !transition.action && !transition.history && !transition.internal;
+			target = unconditional ? transition.target : NumStates;
+		}
+	}
+	return count == 1 ? target : NumStates;
+}
+
+/** @brief Whether the states from `state` up to, but excluding, depth `depth` are all quiet. */
+template <std::size_t NumStates>
+constexpr bool quietBelow(const std::array<StateIndex, NumStates>& parents, const std::array<std::size_t, NumStates>& depths,
+	const std::array<bool, NumStates>& quiet, StateIndex state, std::size_t depth){
+	for (StateIndex current = state; current < NumStates && depths[current] > depth; current = parents[current]){
+		if (!quiet[current]){
+			return false;
+		}
+	}
+	return true;
+}
+} //namespace detail
+
+/**
+ * @brief Innermost active state at the end of the chain of anonymous transitions that starts from each state,
+ * or `NumStates` if the first transition of the chain is not always taken.
+ *
+ * @par Following the chain in a single change of the active states is only equivalent to taking its transitions
+ * one after the other if nothing can be observed in between. So every transition of the chain must always be
+ * taken and have no action, and every state entered or exited along the way must be `quiet`, meaning it has no
+ * entry or exit hooks and no timers, except the states exited by the first transition and those entered by the last.
+ * The chain also may not leave a state that both its first and last states are in. The chain stops before the
+ * first transition that breaks these rules, so that it can be followed by a regular dispatch.
+ */
+template <std::size_t NumStates, std::size_t NumTransitions>
+constexpr std::array<StateIndex, NumStates> make_completion_targets(
+	const std::array<StateIndex, NumStates>& parents,
+	const std::array<std::size_t, NumStates>& depths,
+	const std::array<TransitionFootprint, NumTransitions>& transitions,
+	const std::array<bool, NumStates>& quiet,
+	JEvent no_event_value){
+	std::array<StateIndex, NumStates> targets{};
+	for (StateIndex state = 0; state < NumStates; state++){
+		StateIndex last = detail::unconditionalCompletion(parents, transitions, no_event_value, state);
+		targets[state] = last;
+		if (last >= NumStates){
+			continue;
+		}
+		//the state the previous transition came from, and the shallowest state that no transition so far has left
+		StateIndex previous = state;
+		std::size_t kept_depth = detail::commonDepth(parents, depths, state, last);
+		//unconditional chains cannot loop, as anonymous cycles are rejected, so they have at most NumStates transitions
+		for (std::size_t length = 1; length < NumStates; length++){
+			const StateIndex next = detail::unconditionalCompletion(parents, transitions, no_event_value, last);
+			if (next >= NumStates){
+				break;
+			}
+			const std::size_t next_common = detail::commonDepth(parents, depths, last, next);
+			const std::size_t chain_kept_depth = std::min(kept_depth, next_common);
+			//`last` becomes an intermediate state: what the previous transition entered and the next one exits
+			const bool quiet_middle = detail::quietBelow(parents, depths, quiet, last, detail::commonDepth(parents, depths, previous, last))
+				&& detail::quietBelow(parents, depths, quiet, last, next_common);
+			if (!quiet_middle || detail::commonDepth(parents, depths, state, next) != chain_kept_depth){
+				break;
+			}
+			kept_depth = chain_kept_depth;
+			previous = last;
+			last = next;
+		}
+		targets[state] = last;
+	}
+	return targets;
+}
+
+} //namespace sm
+} //namespace houdini
@@ -0,0 +1,117 @@
+#pragma once
+#include "houdini/sm/backend/event.hpp"
+#include "houdini/sm/backend/timer_event.hpp"
+#include "houdini/util/mp11.hpp"
+#include "houdini/util/types.hpp"
+#include "houdini/util/utility_functions.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Maps each event value in `[0, NumEvents)` to the row of the dispatch table holding its transitions. 
+ * Events that trigger no transition all share the last row, which is always empty. 
+ * 
+ * @par The last `NumTimers` event values are used for time-triggered transitions, and the one before them
+ * for anonymous transitions.
+ */
+template <std::size_t NumEvents>
+struct EventSlots {
+	static_assert(NumEvents < std::numeric_limits<JEvent>::max(), "Too many events for a sparse dispatch table.");
+	std::array<JEvent, NumEvents> slots{};
+	std::size_t rows = 0;
+};
+
+namespace detail {
+template <std::size_t NumEvents, class TimedTransitions, template <class...> class List, class... Transitions>
+constexpr EventSlots<NumEvents> makeEventSlots(List<Transitions...>){
+	constexpr JEvent unassigned = std::numeric_limits<JEvent>::max();
+	constexpr JEvent no_event_value = static_cast<JEvent>(NumEvents - 1 - mp::mp_size<TimedTransitions>::value);
+	EventSlots<NumEvents> result{};
+	for (auto& slot: result.slots){
+		slot = unassigned;
+	}
+	const JEvent events[] = {dispatch_event<TimedTransitions, Transitions>(no_event_value)..., unassigned};
+	for (JEvent event: events){
+		if (event == unassigned){
+			continue;
+		}
+		if (result.slots[event] == unassigned){
+			result.slots[event] = static_cast<JEvent>(result.rows++);
+		}
+	}
+	for (auto& slot: result.slots){
+		if (slot == unassigned){
+			slot = static_cast<JEvent>(result.rows);
+		}
+	}
+	//the shared empty row
+	result.rows++;
+	return result;
+}
+} //namespace detail
+
+/**
+ * @brief Compute the event slots for the transitions in `TransitionList`, a type list of transitions, 
+ * of which `TimedTransitionList` are time-triggered. 
+ */
+template <std::size_t NumEvents, class TransitionList, class TimedTransitionList = mp::mp_list<>>
+constexpr EventSlots<NumEvents> make_event_slots(){
+	return detail::makeEventSlots<NumEvents, TimedTransitionList>(TransitionList{});
+}
+
+/**
+ * @brief Dense dispatch table: one row per event value. 
+ */
+template <class Row, std::size_t NumEvents>
+class DenseDispatchMap {
+	public:
+		static constexpr std::size_t ROWS = NumEvents;
+
+		template <typename Generator>
+		explicit DenseDispatchMap(Generator&& generator) 
+		: rows(util::generate_array<Row, ROWS>(generator)) {}
+
+		Row& operator[](JEvent event){
+			return this->rows[event];
+		}
+
+		const Row& operator[](JEvent event) const {
+			return this->rows[event];
+		}
+
+	private:
+		std::array<Row, ROWS> rows;
+};
+
+/**
+ * @brief Sparse dispatch table: one row per event that triggers a transition, plus one shared empty row. 
+ * Lookups go through a compile-time table from event value to row, so they remain O(1).
+ */
+template <class Row, std::size_t NumEvents, const EventSlots<NumEvents>& Slots>
+class SparseDispatchMap {
+	public:
+		static constexpr std::size_t ROWS = Slots.rows;
+
+		template <typename Generator>
+		explicit SparseDispatchMap(Generator&& generator) 
+		: rows(util::generate_array<Row, ROWS>(generator)) {}
+
+		Row& operator[](JEvent event){
+			return this->rows[Slots.slots[event]];
+		}
+
+		const Row& operator[](JEvent event) const {
+			return this->rows[Slots.slots[event]];
+		}
+
+	private:
+		std::array<Row, ROWS> rows;
+};
+
+} //namespace sm
+} //namespace houdini
@@ -1,14 +1,20 @@
 #pragma once
 #include <cstddef>
+#include "houdini/sm/backend/event_payload.hpp"
+#include "houdini/sm/backend/internal_event_queue.hpp"
 #include "houdini/sm/backend/traits.hpp"
 #include "houdini/sm/backend/index.hpp"
 #include "houdini/sm/frontend/static_stack.hpp"
 
+#include "houdini/memory/allocate_unique.hpp"
+
 #include "houdini/util/unpack_tuple.hpp"
 #include "houdini/util/type_name.hpp"
 #include "houdini/util/types.hpp"
 
 #include <array>
+#include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string_view>
@@ -26,6 +32,45 @@ template <class T> T& get(T& ref){
 	return ref;
 }
 
+/**
+ * @brief Invoke a guard or action. If the event carries a payload and the callable accepts it, 
+ * the payload is passed by const reference after the event. Otherwise the callable is invoked as if 
+ * the event had no payload.
+ */
+template <class Payload, class Callable, class... Dependencies>
+decltype(auto) invokeWithPayload(Callable& callable, JEvent& event, const void* payload, Dependencies&... dependencies){
+	if constexpr (std::is_void_v<Payload>){
+		(void) payload;
+		return callable(event, dependencies...);
+	} else if constexpr (std::is_invocable_v<Callable&, JEvent&, const Payload&, Dependencies&...>){
+		assert(payload && "Event requires a payload.");
+		return callable(event, *static_cast<const Payload*>(payload), dependencies...);
+	} else {
+		(void) payload;
+		return callable(event, dependencies...);
+	}
+}
+
+/**
+ * @brief Invoke an action. Actions that accept the internal event queue of the state machine as their 
+ * last parameter receive it, so they can post follow-up events to their own state machine. 
+ */
+template <class Payload, class Action, class... Dependencies>
+void invokeAction(Action& action, JEvent& event, const void* payload, InternalEventQueue& internal_events, Dependencies&... dependencies){
+	if constexpr (!std::is_void_v<Payload>){
+		if constexpr (std::is_invocable_v<Action&, JEvent&, const Payload&, Dependencies&..., InternalEventQueue&>){
+			assert(payload && "Event requires a payload.");
+			action(event, *static_cast<const Payload*>(payload), dependencies..., internal_events);
+			return;
+		}
+	}
+	if constexpr (std::is_invocable_v<Action&, JEvent&, Dependencies&..., InternalEventQueue&>){
+		action(event, dependencies..., internal_events);
+	} else {
+		invokeWithPayload<Payload>(action, event, payload, dependencies...);
+	}
+}
+
 struct AbstractEventWrapper {
 	virtual ~AbstractEventWrapper() = default;
 };
@@ -43,8 +88,10 @@ struct EventWrapper final : AbstractEventWrapper {
  */
 struct IDispatchTableEntry {
 	virtual ~IDispatchTableEntry() = default;
-	virtual void executeAction(JEvent& event) = 0;
-	virtual bool executeGuard(JEvent& event) = 0;
+	//`payload` points to the payload of the event if it has one, and is `nullptr` otherwise
+	virtual void executeAction(JEvent& event, const void* payload, InternalEventQueue& internal_events) = 0;
+	virtual bool executeGuard(JEvent& event, const void* payload) = 0;
+	virtual bool hasGuard() const noexcept = 0;
 };
 
 /**
@@ -52,12 +99,15 @@ struct IDispatchTableEntry {
  * and guards so that they can be accessed when a specific transition is called. 
  * The "action" and "guard" types are functors or lambdas (in C++20, where
  * lambdas can be default constructible)
+ * 
+ * `Payload` is the payload type of the triggering event, or `void` if it has none.
  */
 template <
 	bool Internal,
 	class Action,
 	class Guard,
-	class OptionalDependency>
+	class OptionalDependency,
+	class Payload = void>
 class DispatchTableEntry final: public IDispatchTableEntry {
 	public:
 		constexpr DispatchTableEntry(
@@ -69,45 +119,51 @@ class DispatchTableEntry final: public IDispatchTableEntry {
 			optional_dependency(optional_dependency_)
 			{}
 		
-		void executeAction(JEvent& event) override {
+		void executeAction(JEvent& event, const void* payload, InternalEventQueue& internal_events) override {
 			if constexpr(is_action<Action>()){
 				[](	auto& action_,
 					auto& event_,
+					const void* payload_,
+					InternalEventQueue& internal_events_,
 					auto& optional_dependencies){
 						util::unpack(
-							[&action_, &event_](auto&... optional_dependency_){
-								action_(event_, get(optional_dependency_)...);
+							[&action_, &event_, payload_, &internal_events_](auto&... optional_dependency_){
+								invokeAction<Payload>(action_, event_, payload_, internal_events_, get(optional_dependency_)...);
 							},
 							optional_dependencies);
-					}(this->action, event, this->optional_dependency);
+					}(this->action, event, payload, internal_events, this->optional_dependency);
 
+			} else {
+				(void) payload;
+				(void) internal_events;
 			}
 		}
 
-		bool executeGuard(JEvent& event) override {
+		bool executeGuard(JEvent& event, const void* payload) override {
 			if constexpr(is_guard<Guard>()) {
 				return [](
 					auto& guard_,
 					auto& event_,
+					const void* payload_,
 					auto& optional_dependencies) {
 						return util::unpack(
-							[&guard_, &event_](auto&... optional_dependency_){
-								if constexpr (Internal){
-									return guard_(event_, get(optional_dependency_)...);
-								}
-								else {
-									return guard_(event_, get(optional_dependency_)...);
-								}
+							[&guard_, &event_, payload_](auto&... optional_dependency_){
+								return invokeWithPayload<Payload>(guard_, event_, payload_, get(optional_dependency_)...);
 							},
 							optional_dependencies
 						);
-					}(this->guard, event, this->optional_dependency);
+					}(this->guard, event, payload, this->optional_dependency);
 			} 
 			else {
+				(void) payload;
 				return true;
 			}
 		}
 
+		bool hasGuard() const noexcept override {
+			return is_guard<Guard>();
+		}
+
 	private:
 		Action action;
 		Guard guard;
@@ -115,24 +171,40 @@ class DispatchTableEntry final: public IDispatchTableEntry {
 };
 
 
+/**
+ * @brief Allocate the dispatch table entry of a transition. Transitions with neither a guard 
+ * nor an action have nothing to execute, so no entry is allocated for them and `nullptr` is returned.
+ */
 template <
+	class EventEnum,
 	class Transition,
 	class Action,
 	class Guard,
 	class Dependency>
-constexpr auto makeDispatchEntry(
+auto makeDispatchEntry(
 	Transition transition,
 	Action action,
 	Guard guard,
 	//JEvent event_type_id,
-	Dependency optional_dependency){
+	Dependency optional_dependency,
+	const JAllocator<std::byte>& alloc) -> JUniquePtr<IDispatchTableEntry> {
 	
-	return std::unique_ptr<IDispatchTableEntry>( //TODO: check if this needs special memory allocation considerations
-		new DispatchTableEntry<
-			transition.internal(),
-			Action,
-			Guard,
-			decltype(optional_dependency)>(action, guard, optional_dependency));
+	if constexpr (!is_action<Action>() && !is_guard<Guard>()){
+		(void) transition;
+		(void) action;
+		(void) guard;
+		(void) optional_dependency;
+		(void) alloc;
+		return nullptr;
+	} else {
+		return memory::allocate_unique<
+			DispatchTableEntry<
+				transition.internal(),
+				Action,
+				Guard,
+				decltype(optional_dependency),
+				EventPayloadT<EventEnum, transition.event()>>>(alloc, action, guard, optional_dependency);
+	}
 }
 
 /**
@@ -144,18 +216,33 @@ constexpr auto makeDispatchEntry(
  * NextState struct, which would lead to excessive metaprogramming complexity and
  * compile times. 
  */
-template <std::size_t Depth>
+template <std::size_t Depth, class Index = StateIndex>
 struct NextState {
-	StaticStack<StateIndex, Depth> destination_states;
+	StaticStack<Index, Depth> destination_states;
 	bool history {}; //change to enum 
 	bool defer {};
 	bool valid = false;
 	bool internal = false;
-	std::unique_ptr<IDispatchTableEntry> transition = nullptr;
-	//TODO: if we want state machines to be copyable 
-	//(e.g. for replication/voting purposes) then we must define
-	//a custom copy constructor for NextState , as unique_ptrs are not copyable
-	//by default.
+	//null for transitions without guard and action, which only change the active states
+	JUniquePtr<IDispatchTableEntry> transition = nullptr;
+#ifdef JANUS_GUARD_PROFILING
+	//position of the transition in its dispatch cell as declared
+	std::uint16_t declared_position = 0;
+#endif
+
+	bool hasGuard() const noexcept {
+		return this->transition && this->transition->hasGuard();
+	}
+
+	bool executeGuard(JEvent& event, const void* payload) const {
+		return !this->transition || this->transition->executeGuard(event, payload);
+	}
+
+	void executeAction(JEvent& event, const void* payload, InternalEventQueue& internal_events) const {
+		if (this->transition){
+			this->transition->executeAction(event, payload, internal_events);
+		}
+	}
 };
 
 } //namespace sm
@@ -0,0 +1,476 @@
+#pragma once
+#include "houdini/sm/backend/event_payload.hpp"
+#include "houdini/sm/backend/state_machine.hpp"
+#include "houdini/util/types.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Layout of a journal file: a `JournalHeader`, followed by records. Each record is a `JournalRecord`
+ * followed by the payload of the event, padded to a multiple of 8 bytes. Only the records before `committed`
+ * are durable. The file is written and read on the same machine, so it is stored as it is laid out in memory.
+ */
+struct JournalHeader {
+	char magic[4] = {'H', 'J', 'R', 'N'};
+	std::uint32_t version = 1;
+	std::uint64_t layout_hash = 0;
+	//offset of the end of the last committed record
+	std::uint64_t committed = 0;
+	//sequence number of the first record. Sequence numbers start at 1.
+	std::uint64_t first_sequence = 1;
+};
+
+struct JournalRecord {
+	std::uint64_t sequence;
+	JEvent event;
+	std::uint16_t payload_size;
+	std::uint32_t reserved;
+};
+
+/** @brief Layout of a checkpoint file: a `CheckpointHeader`, followed by a snapshot written by `SM::snapshot()`. */
+struct CheckpointHeader {
+	char magic[4] = {'H', 'J', 'C', 'K'};
+	std::uint32_t version = 1;
+	//sequence number of the last event included in the snapshot
+	std::uint64_t sequence = 0;
+	std::uint64_t size = 0;
+};
+
+/** @brief Records are padded to a multiple of 8 bytes. */
+constexpr std::size_t journal_record_size(std::size_t payload_size) noexcept {
+	return sizeof(JournalRecord) + ((payload_size + 7) & ~std::size_t{7});
+}
+
+/**
+ * @brief Call `callable(sequence, event, payload, payload_size)` on each record of a journal mapped at `data`,
+ * up to offset `committed`, in order.
+ */
+template <class Callable>
+void forEachJournalRecord(const std::byte* data, std::size_t committed, const Callable& callable){
+	std::size_t offset = sizeof(JournalHeader);
+	while (committed - offset >= sizeof(JournalRecord)){
+		JournalRecord record;
+		std::memcpy(&record, data + offset, sizeof(record));
+		const std::size_t record_size = journal_record_size(record.payload_size);
+		if (committed - offset < record_size){
+			break;
+		}
+		callable(record.sequence, record.event, data + offset + sizeof(record), std::size_t{record.payload_size});
+		offset += record_size;
+	}
+}
+
+/**
+ * @brief Process a journaled event and its payload. Returns `SMResult::ERROR`, without processing it,
+ * if the event is out of range or the payload size does not match the payload declared for the event.
+ * Expired timers are journaled with their dispatch value, after `NO_EVENT_VALUE`, and no payload.
+ */
+template <class StateMachine>
+SMResult processJournaledEvent(StateMachine& state_machine, JEvent event, const std::byte* payload, std::size_t size){
+	using Events = typename StateMachine::Events;
+	constexpr std::size_t num_events = StateMachine::NO_EVENT_VALUE;
+	if (event > num_events && event < StateMachine::DISPATCH_EVENTS){
+		return size ? SMResult::ERROR : state_machine.processTimerEvent(event);
+	}
+	if (event >= num_events || size != payload_sizes<Events, num_events>[event]){
+		return SMResult::ERROR;
+	}
+	const util::TypeidType payload_type = size ? payload_type_ids<Events, num_events>[event] : nullptr;
+	return state_machine.processEvent(EventBuffer(event, payload_type, payload, size));
+}
+
+/** @brief Size of a new journal file, and limits on the records written between group commits. */
+struct JournalOptions {
+	std::size_t capacity = std::size_t{1} << 24;
+	std::size_t commit_bytes = std::size_t{1} << 16;
+	std::chrono::microseconds commit_interval = std::chrono::milliseconds(1);
+};
+
+/**
+ * @brief Journal of events, appended to a memory mapped file of fixed capacity.
+ *
+ * @par Appended records are made durable in groups: `append` commits once `commit_bytes` have been
+ * written or `commit_interval` has passed since the last commit, whichever comes first. A commit
+ * syncs the new records, then the header that marks them as committed, so records are never partially
+ * committed. The time limit is only checked on append, so `commit()` should also be called when the
+ * state machine becomes idle.
+ *
+ * @par A checkpoint, stored next to the journal in `<path>.checkpoint`, holds a snapshot of the state machine.
+ * Writing a checkpoint empties the journal. Recovery restores the checkpoint, then replays the journal.
+ */
+class EventJournal {
+	public:
+		/**
+		 * @brief Open the journal at `path`, creating it if it does not exist. An existing journal must have
+		 * been written by a state machine with the same `layout_hash`, otherwise `good()` is false.
+		 */
+		EventJournal(const std::string& path_, std::uint64_t layout_hash, const JournalOptions& options_ = JournalOptions{})
+		: path(path_), options(options_) {
+			this->fd = ::open(this->path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+			struct stat info{};
+			if (this->fd < 0 || ::fstat(this->fd, &info) != 0){
+				return;
+			}
+			const bool created = info.st_size == 0;
+			if (created && ::ftruncate(this->fd, static_cast<off_t>(this->options.capacity)) != 0){
+				return;
+			}
+			this->capacity = created ? this->options.capacity : static_cast<std::size_t>(info.st_size);
+			if (this->capacity < sizeof(JournalHeader)){
+				return;
+			}
+			void* address = ::mmap(nullptr, this->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+			if (address == MAP_FAILED){
+				return;
+			}
+			this->data = static_cast<std::byte*>(address);
+
+			if (created){
+				JournalHeader header;
+				header.layout_hash = layout_hash;
+				header.committed = sizeof(JournalHeader);
+				std::memcpy(this->data, &header, sizeof(header));
+				this->syncRange(0, sizeof(header));
+			}
+			const JournalHeader& header = this->header();
+			const JournalHeader expected;
+			if (!std::equal(std::begin(header.magic), std::end(header.magic), std::begin(expected.magic))
+				|| header.version != expected.version || header.layout_hash != layout_hash
+				|| header.committed < sizeof(JournalHeader) || header.committed > this->capacity){
+				return;
+			}
+			this->written = header.committed;
+			this->next_sequence = header.first_sequence;
+			this->forEach([this](std::uint64_t sequence, JEvent, const std::byte*, std::size_t){
+				this->next_sequence = sequence + 1;
+			});
+			this->last_commit = std::chrono::steady_clock::now();
+			this->valid = true;
+		}
+
+		EventJournal(const EventJournal&) = delete;
+		EventJournal& operator=(const EventJournal&) = delete;
+
+		~EventJournal(){
+			if (this->valid){
+				this->commit();
+			}
+			if (this->data){
+				::munmap(this->data, this->capacity);
+			}
+			if (this->fd >= 0){
+				::close(this->fd);
+			}
+		}
+
+		bool good() const noexcept {
+			return this->valid;
+		}
+
+		/** @brief Sequence number the next appended record will have. */
+		std::uint64_t nextSequence() const noexcept {
+			return this->next_sequence;
+		}
+
+		/** @brief Bytes of records written since the last checkpoint, committed or not. */
+		std::size_t size() const noexcept {
+			return this->written - sizeof(JournalHeader);
+		}
+
+		/** 
+		 * @brief Append an event and its payload. Returns false if the journal is full, or if the payload is larger 
+		 * than the 65535 bytes a record can hold.
+		 */
+		bool append(JEvent event, const void* payload, std::size_t payload_size){
+			const std::size_t record_size = journal_record_size(payload_size);
+			if (!this->valid || payload_size > std::numeric_limits<std::uint16_t>::max()
+				|| this->capacity - this->written < record_size){
+				return false;
+			}
+			const JournalRecord record{this->next_sequence++, event, static_cast<std::uint16_t>(payload_size), 0};
+			std::memcpy(this->data + this->written, &record, sizeof(record));
+			if (payload_size){
+				std::memcpy(this->data + this->written + sizeof(record), payload, payload_size);
+			}
+			this->written += record_size;
+
+			if (this->written - this->header().committed >= this->options.commit_bytes
+				|| std::chrono::steady_clock::now() - this->last_commit >= this->options.commit_interval){
+				this->commit();
+			}
+			return true;
+		}
+
+		/** @brief Make all appended records durable. */
+		void commit(){
+			JournalHeader& header = this->header();
+			if (this->written > header.committed){
+				this->syncRange(header.committed, this->written - header.committed);
+				header.committed = this->written;
+				this->syncRange(0, sizeof(JournalHeader));
+			}
+			this->last_commit = std::chrono::steady_clock::now();
+		}
+
+		/** @brief Call `callable(sequence, event, payload, payload_size)` on each committed record, in order. */
+		template <class Callable>
+		void forEach(const Callable& callable) const {
+			forEachJournalRecord(this->data, this->header().committed, callable);
+		}
+
+		/**
+		 * @brief Write `snapshot`, which includes all events up to and including `sequence`, as the checkpoint,
+		 * then empty the journal. The checkpoint is replaced atomically. Returns false if it could not be written.
+		 */
+		bool checkpoint(std::uint64_t sequence, const JVector<std::byte>& snapshot){
+			if (!this->valid){
+				return false;
+			}
+			const std::string checkpoint_path = this->path + ".checkpoint";
+			const std::string temporary_path = checkpoint_path + ".tmp";
+			const int checkpoint_fd = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (checkpoint_fd < 0){
+				return false;
+			}
+			CheckpointHeader checkpoint_header;
+			checkpoint_header.sequence = sequence;
+			checkpoint_header.size = snapshot.size();
+			const bool written_out = writeAll(checkpoint_fd, &checkpoint_header, sizeof(checkpoint_header))
+				&& writeAll(checkpoint_fd, snapshot.data(), snapshot.size())
+				&& ::fdatasync(checkpoint_fd) == 0;
+			::close(checkpoint_fd);
+			if (!written_out || std::rename(temporary_path.c_str(), checkpoint_path.c_str()) != 0){
+				return false;
+			}
+			//the rename itself is only durable once the directory is synced. Otherwise, after a crash, 
+			//the previous checkpoint could come back next to the emptied journal.
+			if (!syncDirectory(checkpoint_path)){
+				return false;
+			}
+
+			//records up to `sequence` are skipped on recovery, so a crash before this point loses nothing
+			JournalHeader& header = this->header();
+			header.first_sequence = sequence + 1;
+			header.committed = sizeof(JournalHeader);
+			this->syncRange(0, sizeof(JournalHeader));
+			this->written = sizeof(JournalHeader);
+			this->next_sequence = sequence + 1;
+			return true;
+		}
+
+		/**
+		 * @brief Read the checkpoint into `snapshot`, and the sequence number of the last event it includes
+		 * into `sequence`. Returns false if there is no valid checkpoint.
+		 */
+		bool readCheckpoint(std::uint64_t& sequence, JVector<std::byte>& snapshot) const {
+			const std::string checkpoint_path = this->path + ".checkpoint";
+			const int checkpoint_fd = ::open(checkpoint_path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (checkpoint_fd < 0){
+				return false;
+			}
+			CheckpointHeader checkpoint_header;
+			const CheckpointHeader expected;
+			bool read_in = readAll(checkpoint_fd, &checkpoint_header, sizeof(checkpoint_header))
+				&& std::equal(std::begin(checkpoint_header.magic), std::end(checkpoint_header.magic), std::begin(expected.magic))
+				&& checkpoint_header.version == expected.version;
+			if (read_in){
+				snapshot.resize(checkpoint_header.size);
+				read_in = readAll(checkpoint_fd, snapshot.data(), snapshot.size());
+				sequence = checkpoint_header.sequence;
+			}
+			::close(checkpoint_fd);
+			return read_in;
+		}
+
+	private:
+		static bool writeAll(int file, const void* buffer, std::size_t size){
+			const auto* bytes = static_cast<const std::byte*>(buffer);
+			while (size){
+				const ssize_t count = ::write(file, bytes, size);
+				if (count <= 0){
+					return false;
+				}
+				bytes += count;
+				size -= static_cast<std::size_t>(count);
+			}
+			return true;
+		}
+
+		static bool syncDirectory(const std::string& file_path){
+			const std::size_t separator = file_path.find_last_of('/');
+			const std::string directory = separator == std::string::npos ? std::string(".") 
+				: separator == 0 ? std::string("/") : file_path.substr(0, separator);
+			const int directory_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (directory_fd < 0){
+				return false;
+			}
+			const bool synced = ::fsync(directory_fd) == 0;
+			::close(directory_fd);
+			return synced;
+		}
+
+		static bool readAll(int file, void* buffer, std::size_t size){
+			auto* bytes = static_cast<std::byte*>(buffer);
+			while (size){
+				const ssize_t count = ::read(file, bytes, size);
+				if (count <= 0){
+					return false;
+				}
+				bytes += count;
+				size -= static_cast<std::size_t>(count);
+			}
+			return true;
+		}
+
+		JournalHeader& header() const noexcept {
+			return *reinterpret_cast<JournalHeader*>(this->data);
+		}
+
+		void syncRange(std::size_t offset, std::size_t size){
+			//msync needs a page aligned address
+			static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			const std::size_t begin = offset & ~(page_size - 1);
+			::msync(this->data + begin, offset + size - begin, MS_SYNC);
+		}
+
+		std::string path;
+		JournalOptions options;
+		int fd = -1;
+		std::byte* data = nullptr;
+		std::size_t capacity = 0;
+		std::size_t written = 0;
+		std::uint64_t next_sequence = 0;
+		std::chrono::steady_clock::time_point last_commit;
+		bool valid = false;
+};
+
+/**
+ * @brief Journals the events processed by a state machine, so that its state can be recovered after a crash.
+ * Each event is appended to the journal before it is processed, and a checkpoint is written every
+ * `checkpoint_interval` events, or when the journal is full.
+ *
+ * @par The transitions of expired timers are journaled too, and replayed without waiting for the timers.
+ * Recovery replays the journaled events through the guards and actions of the state machine,
+ * so they must be deterministic for the recovered state to match.
+ */
+template <class StateMachine>
+class JournaledSM {
+	public:
+		using Events = typename StateMachine::Events;
+
+		JournaledSM(StateMachine& state_machine_, EventJournal& journal_, std::size_t checkpoint_interval_ = 100000)
+		: state_machine(state_machine_), journal(journal_), checkpoint_interval(checkpoint_interval_) {
+			this->state_machine.observeTimers(&JournaledSM::onTimer, this);
+		}
+
+		JournaledSM(const JournaledSM&) = delete;
+		JournaledSM& operator=(const JournaledSM&) = delete;
+
+		~JournaledSM(){
+			this->state_machine.observeTimers(nullptr, nullptr);
+		}
+
+		/** @brief Journal, then process an event. Returns `SMResult::ERROR`, without processing it, if it could not be journaled. */
+		SMResult processEvent(Events event){
+			if (!this->record(static_cast<JEvent>(event), nullptr, 0)){
+				return SMResult::ERROR;
+			}
+			return this->state_machine.processEvent(event);
+		}
+
+		template <class Payload>
+		SMResult processEvent(Events event, const Payload& payload){
+			static_assert(sizeof(Payload) <= std::numeric_limits<std::uint16_t>::max(), "Journaled payloads are limited to 65535 bytes.");
+			if (!this->record(static_cast<JEvent>(event), std::addressof(payload), sizeof(Payload))){
+				return SMResult::ERROR;
+			}
+			return this->state_machine.processEvent(event, payload);
+		}
+
+		/** @brief Make all journaled events durable. */
+		void commit(){
+			this->journal.commit();
+		}
+
+		/** @brief Snapshot the state machine into the checkpoint, and empty the journal. */
+		bool checkpoint(){
+			this->since_checkpoint = 0;
+			return this->journal.checkpoint(this->journal.nextSequence() - 1, this->state_machine.snapshot());
+		}
+
+		/**
+		 * @brief Restore the state machine from the checkpoint, if there is one, then replay the committed events
+		 * of the journal that follow it. Must be called before any event is processed. Returns the number
+		 * of events replayed, or nothing if the checkpoint or journal could not be used.
+		 * 
+		 * @par The checkpoint only holds what `SM::snapshot()` saves: the context and the data members
+		 * of states are only recovered to the extent that replaying the journal rebuilds them.
+		 */
+		std::optional<std::size_t> recover(){
+			if (!this->journal.good()){
+				return std::nullopt;
+			}
+			std::uint64_t checkpoint_sequence = 0;
+			JVector<std::byte> snapshot(this->state_machine.allocator);
+			const bool has_checkpoint = this->journal.readCheckpoint(checkpoint_sequence, snapshot);
+			if (has_checkpoint && !this->state_machine.restore(snapshot)){
+				return std::nullopt;
+			}
+
+			std::size_t replayed = 0;
+			this->journal.forEach([&](std::uint64_t sequence, JEvent event, const std::byte* payload, std::size_t size){
+				if (!(has_checkpoint && sequence <= checkpoint_sequence)
+					&& processJournaledEvent(this->state_machine, event, payload, size) != SMResult::ERROR){
+					replayed++;
+				}
+			});
+			this->since_checkpoint = replayed;
+			return replayed;
+		}
+
+	private:
+		static bool onTimer(void* journaled, JEvent event){
+			return static_cast<JournaledSM*>(journaled)->record(event, nullptr, 0);
+		}
+
+		bool record(JEvent event, const void* payload, std::size_t size){
+			if (++this->since_checkpoint > this->checkpoint_interval){
+				this->checkpoint();
+				this->since_checkpoint = 1;
+			}
+			if (this->journal.append(event, payload, size)){
+				return true;
+			}
+			//the journal is full, and a checkpoint empties it
+			if (!this->checkpoint()){
+				return false;
+			}
+			this->since_checkpoint = 1;
+			return this->journal.append(event, payload, size);
+		}
+
+		StateMachine& state_machine;
+		EventJournal& journal;
+		std::size_t checkpoint_interval;
+		std::size_t since_checkpoint = 0;
+};
+
+} //namespace sm
+} //namespace houdini
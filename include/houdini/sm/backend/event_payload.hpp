@@ -0,0 +1,140 @@
+#pragma once
+#include "houdini/util/constants.hpp"
+#include "houdini/util/static_typeid.hpp"
+#include "houdini/util/types.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Associates a payload type with an event value. Events have no payload (`void`) 
+ * unless one is declared with `JANUS_EVENT_PAYLOAD`. 
+ */
+template <class EventEnum, JEvent EnumValue>
+struct EventPayload {
+	using type = void;
+};
+
+template <class EventEnum, JEvent EnumValue>
+using EventPayloadT = typename EventPayload<EventEnum, EnumValue>::type;
+
+/**
+ * @brief Payloads are copied into an `EventBuffer` byte for byte, so they must be trivially copyable 
+ * and fit in `JANUS_MAX_EVENT_PAYLOAD_SIZE` bytes.
+ */
+template <class Payload>
+constexpr bool is_valid_payload() {
+	return std::is_trivially_copyable_v<Payload>
+		&& sizeof(Payload) <= JANUS_MAX_EVENT_PAYLOAD_SIZE
+		&& alignof(Payload) <= alignof(std::max_align_t);
+}
+
+namespace detail {
+template <class EventEnum, std::size_t... Is>
+constexpr auto makePayloadTypeIds(std::index_sequence<Is...>){
+	return std::array<util::TypeidType, sizeof...(Is)>{
+		util::type_id<EventPayloadT<EventEnum, static_cast<JEvent>(Is)>>()...
+	};
+}
+
+template <class Payload>
+constexpr std::size_t payloadSize(){
+	if constexpr (std::is_void_v<Payload>){
+		return 0;
+	} else {
+		return sizeof(Payload);
+	}
+}
+
+template <class EventEnum, std::size_t... Is>
+constexpr auto makePayloadSizes(std::index_sequence<Is...>){
+	return std::array<std::size_t, sizeof...(Is)>{
+		payloadSize<EventPayloadT<EventEnum, static_cast<JEvent>(Is)>>()...
+	};
+}
+} //namespace detail
+
+/**
+ * @brief Table of the payload type id of each event value in `[0, NumEvents)`. Used to check 
+ * at runtime that the payload passed with an event has the declared type. 
+ */
+template <class EventEnum, std::size_t NumEvents>
+constexpr std::array<util::TypeidType, NumEvents> payload_type_ids = 
+	detail::makePayloadTypeIds<EventEnum>(std::make_index_sequence<NumEvents>{});
+
+/** @brief Table of the payload size of each event value in `[0, NumEvents)`, 0 for events without payload. */
+template <class EventEnum, std::size_t NumEvents>
+constexpr std::array<std::size_t, NumEvents> payload_sizes = 
+	detail::makePayloadSizes<EventEnum>(std::make_index_sequence<NumEvents>{});
+
+/**
+ * @brief An event value together with its payload, stored in place. 
+ * Used wherever an event with a payload must outlive the call that raised it (in a queue, for example) 
+ * without allocating. 
+ */
+class EventBuffer {
+	public:
+		EventBuffer() = default;
+
+		template <class EventEnum, typename = std::enable_if_t<std::is_enum_v<EventEnum>>>
+		explicit EventBuffer(EventEnum event) noexcept : event_id(static_cast<JEvent>(event)) {}
+
+		template <class EventEnum, class Payload>
+		EventBuffer(EventEnum event, const Payload& payload) noexcept 
+		: event_id(static_cast<JEvent>(event)), payload_type(util::type_id<Payload>()) {
+			static_assert(is_valid_payload<Payload>(), 
+				"Event payloads must be trivially copyable and no larger than JANUS_MAX_EVENT_PAYLOAD_SIZE.");
+			std::memcpy(this->storage, std::addressof(payload), sizeof(Payload));
+		}
+
+		/** 
+		 * @brief Event with a payload of type `payload_type_` copied from `size` raw bytes, such as a payload 
+		 * read back from a file. `payload_type_` is `nullptr` for events without payload.
+		 */
+		EventBuffer(JEvent event, util::TypeidType payload_type_, const void* payload_, std::size_t size) noexcept
+		: event_id(event), payload_type(payload_type_) {
+			assert(size <= JANUS_MAX_EVENT_PAYLOAD_SIZE);
+			if (size){
+				std::memcpy(this->storage, payload_, size);
+			}
+		}
+
+		JEvent id() const noexcept {
+			return this->event_id;
+		}
+
+		/** @brief Pointer to the stored payload, or `nullptr` if the event has none. */
+		const void* payload() const noexcept {
+			return this->payload_type ? static_cast<const void*>(this->storage) : nullptr;
+		}
+
+		util::TypeidType payloadType() const noexcept {
+			return this->payload_type;
+		}
+
+	private:
+		JEvent event_id = 0;
+		util::TypeidType payload_type = nullptr;
+		alignas(std::max_align_t) std::byte storage[JANUS_MAX_EVENT_PAYLOAD_SIZE];
+};
+
+} //namespace sm
+} //namespace houdini
+
+/**
+ * Declare the payload carried by an event. Must be used at global scope. Guards and actions of transitions 
+ * triggered by the event may then take the payload by const reference after the event: `(JEvent, const Payload&, Context&, Broker&)`.
+ */
+#define JANUS_EVENT_PAYLOAD(EnumType, value, PayloadType) \
+	template <> struct houdini::sm::EventPayload<EnumType, static_cast<houdini::JEvent>(value)> { \
+		static_assert(houdini::sm::is_valid_payload<PayloadType>(), \
+			"Event payloads must be trivially copyable and no larger than JANUS_MAX_EVENT_PAYLOAD_SIZE."); \
+		using type = PayloadType; \
+	}
@@ -0,0 +1,242 @@
+#pragma once
+#include "houdini/sm/backend/event_journal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Read-only view of the committed records of a recorded journal, memory mapped from disk.
+ * The file is not modified, and may be replayed by several threads at once.
+ */
+class ReplayStream {
+	public:
+		/** @brief Map the journal at `path`, which must have been recorded by a state machine with the same `layout_hash`. */
+		ReplayStream(const std::string& path, std::uint64_t layout_hash){
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			struct stat info{};
+			if (fd < 0){
+				return;
+			}
+			if (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(JournalHeader)){
+				this->size = static_cast<std::size_t>(info.st_size);
+				void* address = ::mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+				this->data = address == MAP_FAILED ? nullptr : static_cast<const std::byte*>(address);
+			}
+			::close(fd);
+			if (!this->data){
+				return;
+			}
+			//records are read in order, once
+			::madvise(const_cast<std::byte*>(this->data), this->size, MADV_SEQUENTIAL);
+
+			JournalHeader header;
+			std::memcpy(&header, this->data, sizeof(header));
+			const JournalHeader expected;
+			this->valid = std::equal(std::begin(header.magic), std::end(header.magic), std::begin(expected.magic))
+				&& header.version == expected.version && header.layout_hash == layout_hash
+				&& header.committed >= sizeof(JournalHeader) && header.committed <= this->size;
+			this->committed = header.committed;
+		}
+
+		ReplayStream(const ReplayStream&) = delete;
+		ReplayStream& operator=(const ReplayStream&) = delete;
+
+		~ReplayStream(){
+			if (this->data){
+				::munmap(const_cast<std::byte*>(this->data), this->size);
+			}
+		}
+
+		bool good() const noexcept {
+			return this->valid;
+		}
+
+		/** @brief Call `callable(sequence, event, payload, payload_size)` on each committed record, in order. */
+		template <class Callable>
+		void forEach(const Callable& callable) const {
+			if (this->valid){
+				forEachJournalRecord(this->data, this->committed, callable);
+			}
+		}
+
+	private:
+		const std::byte* data = nullptr;
+		std::size_t size = 0;
+		std::size_t committed = 0;
+		bool valid = false;
+};
+
+struct ReplayStats {
+	std::size_t events = 0;
+	//records that could not be processed, because their event or payload does not match the state machine
+	std::size_t invalid_events = 0;
+	std::chrono::nanoseconds elapsed{0};
+
+	double eventsPerSecond() const noexcept {
+		return this->elapsed.count() ? 1e9 * static_cast<double>(this->events) / static_cast<double>(this->elapsed.count()) : 0.0;
+	}
+};
+
+/**
+ * @brief Process all events of `stream` through `state_machine` on the calling thread, as fast as possible.
+ * `observer(sequence, result, state_machine)` is called after each event, to check or record the configuration
+ * the event led to.
+ */
+template <class StateMachine, class Observer>
+ReplayStats replay(StateMachine& state_machine, const ReplayStream& stream, Observer&& observer){
+	ReplayStats stats;
+	const auto start = std::chrono::steady_clock::now();
+	stream.forEach([&](std::uint64_t sequence, JEvent event, const std::byte* payload, std::size_t size){
+		const SMResult result = processJournaledEvent(state_machine, event, payload, size);
+		if (result == SMResult::ERROR){
+			stats.invalid_events++;
+			return;
+		}
+		stats.events++;
+		observer(sequence, result, static_cast<const StateMachine&>(state_machine));
+	});
+	stats.elapsed = std::chrono::steady_clock::now() - start;
+	return stats;
+}
+
+template <class StateMachine>
+ReplayStats replay(StateMachine& state_machine, const ReplayStream& stream){
+	return replay(state_machine, stream, [](std::uint64_t, SMResult, const StateMachine&){});
+}
+
+/**
+ * @brief Active states of a state machine after each event of a replay, in order. A trace recorded from
+ * a known good build can be saved, and later replays checked against it with `checker()`.
+ */
+class ConfigurationTrace {
+	public:
+		/** @brief Observer for `replay` that appends the active states after each event. */
+		auto recorder(){
+			return [this](std::uint64_t, SMResult, const auto& state_machine){
+				this->configurations.push_back(static_cast<std::uint16_t>(state_machine.currentState()));
+			};
+		}
+
+		/**
+		 * @brief Observer for `replay` that compares the active states after each event with the trace,
+		 * counting the events that differ in `mismatches` and recording the sequence number of the first one.
+		 */
+		auto checker(){
+			this->position = 0;
+			this->mismatches = 0;
+			this->first_mismatch = 0;
+			return [this](std::uint64_t sequence, SMResult, const auto& state_machine){
+				const bool matches = this->position < this->configurations.size()
+					&& this->configurations[this->position] == state_machine.currentState();
+				if (!matches && this->mismatches++ == 0){
+					this->first_mismatch = sequence;
+				}
+				this->position++;
+			};
+		}
+
+		/** 
+		 * @brief Whether the replay checked by the last `checker` matched the whole trace: a replay that stops 
+		 * before the end of the trace has no mismatches, but is not complete.
+		 */
+		bool complete() const noexcept {
+			return this->mismatches == 0 && this->position == this->configurations.size();
+		}
+
+		bool save(const std::string& path) const {
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			const std::uint64_t count = this->configurations.size();
+			file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+			file.write(reinterpret_cast<const char*>(this->configurations.data()),
+				static_cast<std::streamsize>(count * sizeof(std::uint16_t)));
+			return file.good();
+		}
+
+		bool load(const std::string& path){
+			std::ifstream file(path, std::ios::binary);
+			std::uint64_t count = 0;
+			if (!file.read(reinterpret_cast<char*>(&count), sizeof(count))){
+				return false;
+			}
+			this->configurations.resize(count);
+			return static_cast<bool>(file.read(reinterpret_cast<char*>(this->configurations.data()),
+				static_cast<std::streamsize>(count * sizeof(std::uint16_t))));
+		}
+
+		std::vector<std::uint16_t> configurations;
+		std::size_t mismatches = 0;
+		std::uint64_t first_mismatch = 0;
+
+	private:
+		std::size_t position = 0;
+};
+
+struct ParallelReplayStats {
+	std::vector<ReplayStats> streams;
+	std::size_t threads = 0;
+	std::chrono::nanoseconds elapsed{0};
+
+	std::size_t events() const noexcept {
+		std::size_t total = 0;
+		for (const ReplayStats& stream:this->streams){
+			total += stream.events;
+		}
+		return total;
+	}
+
+	/** @brief Events processed per second of wall time, per thread. */
+	double eventsPerSecondPerThread() const noexcept {
+		return this->elapsed.count() && this->threads
+			? 1e9 * static_cast<double>(this->events()) / static_cast<double>(this->elapsed.count()) / static_cast<double>(this->threads)
+			: 0.0;
+	}
+};
+
+/**
+ * @brief Replay `num_streams` independent streams over a pool of `threads` threads. `job(i)` replays stream `i`
+ * and returns its stats. It is called on a pool thread, and should construct the state machine, context and broker
+ * it replays into, so that streams share nothing.
+ */
+template <class Job>
+ParallelReplayStats replayInParallel(std::size_t num_streams, std::size_t threads, const Job& job){
+	ParallelReplayStats stats;
+	stats.streams.resize(num_streams);
+	stats.threads = std::max<std::size_t>(1, std::min(threads, num_streams));
+
+	std::atomic<std::size_t> next{0};
+	auto worker = [&](){
+		for (std::size_t i = next++; i < num_streams; i = next++){
+			stats.streams[i] = job(i);
+		}
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (std::size_t i = 1; i < stats.threads; i++){
+		pool.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& thread:pool){
+		thread.join();
+	}
+	stats.elapsed = std::chrono::steady_clock::now() - start;
+	return stats;
+}
+
+} //namespace sm
+} //namespace houdini
@@ -0,0 +1,277 @@
+#pragma once
+#include "houdini/sm/backend/fill_dispatch_table.hpp"
+#include "houdini/sm/backend/index.hpp"
+#include "houdini/sm/backend/resolve_state.hpp"
+#include "houdini/sm/backend/timer_event.hpp"
+#include "houdini/sm/backend/traits.hpp"
+
+#include "houdini/util/mp11.hpp"
+#include "houdini/util/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Upper bounds on the work done by `processEvent` for a single event, computed at compile time from
+ * the transition table. They include the chain of anonymous transitions the event can lead to, but not the
+ * events posted to the internal event queue or the deferred events processed afterwards, each of which
+ * is bounded in the same way.
+ */
+struct ExecutionBounds {
+	std::size_t exits = 0;
+	std::size_t entries = 0;
+	//guards evaluated, assuming that every guard but the last fails
+	std::size_t guards = 0;
+	std::size_t actions = 0;
+	//longest sequence of anonymous transitions that can follow an event
+	std::size_t anonymous_chain = 0;
+	//false if anonymous transitions can form a cycle, in which case the other bounds are meaningless
+	bool bounded = true;
+	//the innermost active state and event value of the dispatch table cell with the most work
+	StateIndex worst_state = 0;
+	JEvent worst_event = 0;
+};
+
+/** @brief What the dispatch table entry of a transition does, as needed to bound its cost. */
+struct TransitionFootprint {
+	JEvent event;
+	StateIndex source;
+	StateIndex target;
+	bool history;
+	bool internal;
+	bool guard;
+	bool action;
+};
+
+namespace detail {
+template <class StateMap, class Path>
+constexpr StateIndex parentIndex(){
+	if constexpr (mp::mp_size<Path>::value > 1){
+		return mp::mp_find<StateMap, mp::mp_rest<Path>>::value;
+	} else {
+		return mp::mp_size<StateMap>::value;
+	}
+}
+
+template <class StateMap, template <class...> class List, class... Paths>
+constexpr std::array<StateIndex, sizeof...(Paths)> makeStateParents(List<Paths...>){
+	return {parentIndex<StateMap, Paths>()...};
+}
+
+template <template <class...> class List, class... Paths>
+constexpr std::array<std::size_t, sizeof...(Paths)> makeStateDepths(List<Paths...>){
+	return {mp::mp_size<Paths>::value...};
+}
+
+template <class StateMap, class TimedTransitions, class Transition>
+constexpr TransitionFootprint makeFootprint(JEvent no_event_value){
+	constexpr Transition transition{};
+	return TransitionFootprint{
+		dispatch_event<TimedTransitions, Transition>(no_event_value),
+		getCombinedStateIndex(StateMap{}, resolveSrcParents(transition), resolveSrc(transition)),
+		mp::mp_find<StateMap, decltype(resolveInitialStateParents(transition))>::value,
+		resolveHistory(transition),
+		transition.internal(),
+		is_guard<typename Transition::guard_t>(),
+		is_action<typename Transition::action_t>()};
+}
+
+template <class StateMap, class TimedTransitions, template <class...> class List, class... Transitions>
+constexpr std::array<TransitionFootprint, sizeof...(Transitions)> makeFootprints(List<Transitions...>, JEvent no_event_value){
+	return {makeFootprint<StateMap, TimedTransitions, Transitions>(no_event_value)...};
+}
+
+template <std::size_t NumStates>
+constexpr bool isAncestorOrSelf(const std::array<StateIndex, NumStates>& parents, StateIndex ancestor, StateIndex state){
+	for (StateIndex current = state; current < NumStates; current = parents[current]){
+		if (current == ancestor){
+			return true;
+		}
+	}
+	return false;
+}
+
+/** @brief Depth of the innermost state that is both an ancestor of `a` and of `b`, which a transition neither exits nor enters. */
+template <std::size_t NumStates>
+constexpr std::size_t commonDepth(const std::array<StateIndex, NumStates>& parents,
+	const std::array<std::size_t, NumStates>& depths, StateIndex a, StateIndex b){
+	if (a >= NumStates || b >= NumStates){
+		return 1;
+	}
+	while (depths[a] > depths[b]){
+		a = parents[a];
+	}
+	while (depths[b] > depths[a]){
+		b = parents[b];
+	}
+	while (a != b && a < NumStates && b < NumStates){
+		a = parents[a];
+		b = parents[b];
+	}
+	return a < NumStates ? depths[a] : 1;
+}
+
+/** @brief Whether no transition before the `index`-th one is dispatched under the same event. */
+template <std::size_t NumTransitions>
+constexpr bool firstOfEvent(const std::array<TransitionFootprint, NumTransitions>& transitions, std::size_t index){
+	for (std::size_t i = 0; i < index; i++){
+		if (transitions[i].event == transitions[index].event){
+			return false;
+		}
+	}
+	return true;
+}
+
+struct CellCost {
+	std::size_t exits = 0;
+	std::size_t entries = 0;
+	std::size_t guards = 0;
+	std::size_t actions = 0;
+
+	constexpr std::size_t total() const {
+		return this->exits + this->entries + this->guards + this->actions;
+	}
+};
+
+/** @brief Work done when `event` is dispatched while `state` is the innermost active state. */
+template <std::size_t NumStates, std::size_t NumTransitions>
+constexpr CellCost cellCost(const std::array<StateIndex, NumStates>& parents, const std::array<std::size_t, NumStates>& depths,
+	const std::array<TransitionFootprint, NumTransitions>& transitions, JEvent event, StateIndex state, std::size_t max_depth){
+	CellCost cost{};
+	for (const TransitionFootprint& transition:transitions){
+		//transitions of a parent state are also taken from all of its child states
+		const bool applies = transition.event == event && (transition.source == state
+			|| (!transition.internal && isAncestorOrSelf(parents, transition.source, state)));
+		if (!applies){
+			continue;
+		}
+		cost.guards += transition.guard;
+		cost.actions = std::max<std::size_t>(cost.actions, transition.action);
+		if (!transition.internal){
+			const std::size_t common = commonDepth(parents, depths, state, transition.target);
+			const std::size_t target_depth = transition.history || transition.target >= NumStates
+				? max_depth : depths[transition.target];
+			cost.exits = std::max(cost.exits, depths[state] - std::min(common, depths[state]));
+			cost.entries = std::max(cost.entries, target_depth - std::min(common, target_depth));
+		}
+	}
+	return cost;
+}
+} //namespace detail
+
+/** @brief Index of the parent of each state of `StateMap`, `NumStates` for the root state. */
+template <class StateMap>
+constexpr auto make_state_parents(){
+	return detail::makeStateParents<StateMap>(StateMap{});
+}
+
+/** @brief Number of states in the path from the root state to each state of `StateMap`, including both. */
+template <class StateMap>
+constexpr auto make_state_depths(){
+	return detail::makeStateDepths(StateMap{});
+}
+
+template <class StateMap, class TimedTransitions, class TransitionList>
+constexpr auto make_transition_footprints(JEvent no_event_value){
+	return detail::makeFootprints<StateMap, TimedTransitions>(TransitionList{}, no_event_value);
+}
+
+/**
+ * @brief Bound the work done by a single event, given the tree of states and the footprint of all transitions.
+ * Every event is assumed to be possible in every state, and every guard to fail but the last, so the bounds 
+ * are conservative.
+ */
+template <std::size_t NumStates, std::size_t NumTransitions>
+constexpr ExecutionBounds compute_execution_bounds(
+	const std::array<StateIndex, NumStates>& parents,
+	const std::array<std::size_t, NumStates>& depths,
+	const std::array<TransitionFootprint, NumTransitions>& transitions,
+	JEvent no_event_value,
+	std::size_t max_depth){
+	ExecutionBounds bounds{};
+
+	//the most expensive event, from any state
+	detail::CellCost worst{};
+	std::size_t worst_total = 0;
+	for (std::size_t i = 0; i < NumTransitions; i++){
+		const TransitionFootprint& transition = transitions[i];
+		if (transition.event == no_event_value || !detail::firstOfEvent(transitions, i)){
+			continue;
+		}
+		for (StateIndex state = 0; state < NumStates; state++){
+			const detail::CellCost cost = detail::cellCost(parents, depths, transitions, transition.event, state, max_depth);
+			worst.exits = std::max(worst.exits, cost.exits);
+			worst.entries = std::max(worst.entries, cost.entries);
+			worst.guards = std::max(worst.guards, cost.guards);
+			worst.actions = std::max(worst.actions, cost.actions);
+			if (cost.total() > worst_total){
+				worst_total = cost.total();
+				bounds.worst_state = state;
+				bounds.worst_event = transition.event;
+			}
+		}
+	}
+
+	//the most expensive anonymous transition, from any state, and the longest chain of them.
+	//a chain can only get longer than the number of states if anonymous transitions form a cycle.
+	detail::CellCost anonymous{};
+	std::array<std::size_t, NumStates> chain_lengths{};
+	bool has_anonymous = false;
+	for (std::size_t round = 0; round <= NumStates; round++){
+		bool changed = false;
+		for (StateIndex state = 0; state < NumStates; state++){
+			for (const TransitionFootprint& transition:transitions){
+				if (transition.event != no_event_value || transition.internal
+					|| !detail::isAncestorOrSelf(parents, transition.source, state)){
+					continue;
+				}
+				has_anonymous = true;
+				//with history, the state machine can end up in any descendant of the target
+				std::size_t next_chain = 0;
+				for (StateIndex next = 0; next < NumStates; next++){
+					const bool reachable = next == transition.target
+						|| (transition.history && detail::isAncestorOrSelf(parents, transition.target, next));
+					if (reachable){
+						next_chain = std::max(next_chain, chain_lengths[next]);
+					}
+				}
+				if (chain_lengths[state] < next_chain + 1){
+					chain_lengths[state] = next_chain + 1;
+					changed = true;
+				}
+			}
+		}
+		if (!changed){
+			break;
+		}
+		if (round == NumStates){
+			bounds.bounded = false;
+		}
+	}
+	if (has_anonymous){
+		for (StateIndex state = 0; state < NumStates; state++){
+			const detail::CellCost cost = detail::cellCost(parents, depths, transitions, no_event_value, state, max_depth);
+			anonymous.exits = std::max(anonymous.exits, cost.exits);
+			anonymous.entries = std::max(anonymous.entries, cost.entries);
+			anonymous.guards = std::max(anonymous.guards, cost.guards);
+			anonymous.actions = std::max(anonymous.actions, cost.actions);
+			bounds.anonymous_chain = std::max(bounds.anonymous_chain, chain_lengths[state]);
+		}
+	}
+
+	const std::size_t chain_length = bounds.anonymous_chain;
+	bounds.exits = worst.exits + chain_length * anonymous.exits;
+	bounds.entries = worst.entries + chain_length * anonymous.entries;
+	bounds.actions = worst.actions + chain_length * anonymous.actions;
+	//the guards of the last state reached are evaluated once more, and all fail
+	bounds.guards = worst.guards + (has_anonymous ? (chain_length + 1) * anonymous.guards : 0);
+	return bounds;
+}
+
+} //namespace sm
+} //namespace houdini
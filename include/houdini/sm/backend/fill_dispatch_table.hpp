@@ -85,7 +85,7 @@ template <
 	class DispatchMap,
 	class Dependencies>
 constexpr void addDispatchTableEntry(
-	SM&,
+	SM& sm,
 	TransitionTuple transition,
 	DispatchMap& dispatch_map,
 	JEvent event_id,
@@ -104,17 +104,17 @@ constexpr void addDispatchTableEntry(
 	constexpr std::size_t from_index = getCombinedStateIndex(StateMap{}, resolveSrcParents(transition), resolveSrc(transition));
 	constexpr std::size_t n_states = SM::NUM_STATES;
 
-	StaticStack<StateIndex, max_depth> state_indices{
-		get_state_indices<decltype(dest_parents), StateMap, n_states, max_depth>()};
+	auto state_indices = get_state_indices<decltype(dest_parents), StateMap, n_states, max_depth>();
 
 	static_assert(from_index < n_states, "From index not found in dispatch map!");
 
 	auto& dispatch_table = dispatch_map[event_id];
-	auto dispatch_table_entry = makeDispatchEntry(
+	auto dispatch_table_entry = makeDispatchEntry<typename SM::Events>(
 		transition,
 		transition.action(),
 		transition.guard(),
-		optional_dependency);
+		optional_dependency,
+		sm.allocator);
 
 
 	const bool is_history = resolveHistory(transition);
@@ -123,7 +123,7 @@ constexpr void addDispatchTableEntry(
 	const bool valid = true;
 
 	dispatch_table[from_index].push_back(
-		NextState<max_depth>{ 
+		NextState<max_depth, NarrowStateIndex<n_states>>{ 
 			state_indices, 
 			is_history, //TODO: change to enum ?
 			defer, 
@@ -146,7 +146,7 @@ template <
 	class DispatchMap,
 	class Dependencies>
 constexpr void addDispatchTableEntryForSubStates(
-	SM&,
+	SM& sm,
 	TransitionTuple transition,
 	DispatchMap& dispatch_map,
 	JEvent event_id,
@@ -170,7 +170,7 @@ constexpr void addDispatchTableEntryForSubStates(
 
 		auto dest_parents = detail::resolveInitialStateParents(transition);
 		//std::cout << "Type name of parents of substate: " << util::type_name(dest_parents) << std::endl;
-		StaticStack<StateIndex, max_depth> state_indices = get_state_indices<decltype(dest_parents), StateMap, n_states, max_depth>();
+		auto state_indices = get_state_indices<decltype(dest_parents), StateMap, n_states, max_depth>();
 		
 		constexpr auto history = resolveHistory(transition);	
 		constexpr auto defer = false;
@@ -190,16 +190,17 @@ constexpr void addDispatchTableEntryForSubStates(
 			// std::cout << "Substate From index and event: " << from_index << ", " << event_id << std::endl; 
 
 			auto& dispatch_table = dispatch_map[event_id];
-			auto dispatch_table_entry = makeDispatchEntry(
+			auto dispatch_table_entry = makeDispatchEntry<typename SM::Events>(
 					transition,
 					transition.action(),
 					transition.guard(),
-					optional_dependency);
+					optional_dependency,
+					sm.allocator);
 			
 			const bool internal = transition.internal();
 
 			dispatch_table[from_index].push_back(
-				NextState<max_depth>{
+				NextState<max_depth, NarrowStateIndex<n_states>>{
 					std::move(state_indices), 
 					history, 
 					defer, 
@@ -211,6 +212,7 @@ constexpr void addDispatchTableEntryForSubStates(
 		);
 	} 
 	//disable compiler warnings for unused parameters
+	(void) sm;
 	(void) event_id;
 	(void) optional_dependency;
 	(void) dispatch_map;
@@ -234,18 +236,14 @@ constexpr auto fillDispatchTableWithTransitions(
 	Dependencies&& optional_dependency,
 	TransitionTuple) {
 	
-	using EventEnum = typename SM::Events;
 
 	//constexpr auto event_ids = collectEventTypeIDsRecursiveFromTransitions(transitions);
 	mp::mp_for_each<TransitionTuple>(
 		[&sm, &optional_dependency, &dispatch_map](auto transition){
 
-			JEvent event_id = transition.event();
-			if (event_id == PLACEHOLDER_NO_EVENT_VALUE) {
-				//set anonymous transition event id to last enum value + 1
-				//to avoid going out of bounds on event_id static map array
-				event_id = util::enum_max_value<EventEnum>() + 1;
-			}
+			//anonymous and time-triggered transitions are stored after the last enum value
+			//to avoid going out of bounds on event_id static map array
+			JEvent event_id = SM::template dispatchEvent<decltype(transition)>();
 			addDispatchTableEntryForSubStates(
 				sm,
 				transition,
@@ -287,22 +285,23 @@ constexpr auto fillDispatchTableWithDeferredEvents(
 				assert(from_index < n_states && "From index not found in dispatch map!");
 				//TODO: FIX THIS
 				
-				StaticStack<StateIndex, max_depth> state_indices = get_state_indices<decltype(dest_parents), StateMap, n_states, max_depth>();
+				auto state_indices = get_state_indices<decltype(dest_parents), StateMap, n_states, max_depth>();
 				
 				const bool history = resolveHistory(transition);
 				const bool defer = true;
 				const bool valid = true;
 				
 				auto& dispatch_table = dispatch_map[event];
-				auto dispatch_table_entry = makeDispatchEntry(
+				auto dispatch_table_entry = makeDispatchEntry<typename SM::Events>(
 						transition,
 						transition.action(),
 						transition.guard(),
-						optional_dependency);
+						optional_dependency,
+						state_machine.allocator);
 
 				bool internal = transition.internal();
 				dispatch_table[from_index].push_back({
-					NextState<max_depth>{
+					NextState<max_depth, NarrowStateIndex<n_states>>{
 						std::move(state_indices),
 						history,
 						defer,
@@ -318,14 +317,15 @@ constexpr auto fillDispatchTableWithDeferredEvents(
 }
 
 
-template <class SM, class OptionalDependency>
+template <class SM, class DispatchMap, class OptionalDependency>
 constexpr auto fillDispatchTableWithExternalTransitions(
 	SM& sm,
+	DispatchMap& dispatch_map,
 	OptionalDependency&& optional_dependency){
 	
 	fillDispatchTableWithTransitions(
 		sm,
-		sm.dispatch_map,
+		dispatch_map,
 		optional_dependency,
 		sortTransitionTableByParentSize(flattenTransitionTable(sm.root_state)) //needs to be flattened
 	);
@@ -333,14 +333,15 @@ constexpr auto fillDispatchTableWithExternalTransitions(
 }
 
 
-template <class SM, class OptionalDependency>
+template <class SM, class DispatchMap, class OptionalDependency>
 constexpr auto fillDispatchTableWithInternalTransitions(
 	SM& sm,
+	DispatchMap& dispatch_map,
 	OptionalDependency&& optional_dependency){
 	
 	fillDispatchTableWithTransitions(
 		sm,
-		sm.dispatch_map,
+		dispatch_map,
 		optional_dependency,
 		sortTransitionTableByParentSize(flattenInternalTransitionTable(sm.root_state))
 	);
@@ -0,0 +1,123 @@
+#pragma once
+#include "houdini/util/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Number of times the guard of a transition passed. The transition is identified by the
+ * dispatch table cell it is stored in (event and state index) and by its position in that cell,
+ * in declaration order.
+ */
+struct GuardHits {
+	JEvent event;
+	std::size_t state;
+	std::size_t position;
+	std::uint32_t hits;
+};
+
+/**
+ * @brief Guard hit counts recorded for the state machine with root state `Root`.
+ * Empty unless a profile is declared with `JANUS_GUARD_PROFILE`, usually in a header
+ * generated by `SM::writeGuardProfile`.
+ */
+template <class Root>
+struct GuardProfile {
+	static constexpr std::array<GuardHits, 0> hits{};
+};
+
+template <class Root>
+constexpr bool has_guard_profile(){
+	return std::size(GuardProfile<Root>::hits) > 0;
+}
+
+namespace detail {
+template <class Root>
+std::uint32_t profiledHits(JEvent event, std::size_t state, std::size_t position){
+	for (const GuardHits& entry:GuardProfile<Root>::hits){
+		if (entry.event == event && entry.state == state && entry.position == position){
+			return entry.hits;
+		}
+	}
+	return 0;
+}
+} //namespace detail
+
+/**
+ * @brief Reorder the transitions of a dispatch table cell so that the guards that passed most often
+ * in the profile of `Root` are evaluated first.
+ *
+ * @par Only consecutive guarded transitions are reordered. A transition without guard always
+ * passes, and a deferral takes effect as soon as it is reached, so neither is moved and no
+ * transition is moved past them. Declaring a profile asserts that the guards of the reordered
+ * transitions are mutually exclusive, so that the order in which they are evaluated does not
+ * change which transition is taken.
+ */
+template <class Root, class Cell>
+void sortByGuardProfile(Cell& cell, JEvent event, std::size_t state){
+	using Entry = typename Cell::value_type;
+
+	auto orderable = [](const Entry& entry){ return !entry.defer && entry.hasGuard(); };
+
+	JVector<std::pair<std::uint32_t, Entry>> run(cell.get_allocator());
+	std::size_t i = 0;
+	while (i < cell.size()){
+		if (!orderable(cell[i])){
+			i++;
+			continue;
+		}
+
+		const std::size_t begin = i;
+		for (; i < cell.size() && orderable(cell[i]); i++){
+			run.emplace_back(detail::profiledHits<Root>(event, state, i), std::move(cell[i]));
+		}
+		std::stable_sort(run.begin(), run.end(), [](const auto& a, const auto& b){ return a.first > b.first; });
+		for (std::size_t j = 0; j < run.size(); j++){
+			cell[begin + j] = std::move(run[j].second);
+		}
+		run.clear();
+	}
+}
+
+/**
+ * @brief Write `hits` as a header that declares the guard profile of `Root`. Including the header
+ * before the state machine is instantiated applies the profile.
+ */
+template <class Hits>
+void writeGuardProfileHeader(std::ostream& os, std::string_view root_name, const Hits& hits){
+	os << "//Guard profile generated by houdini. Include before instantiating the state machine.\n";
+	os << "#pragma once\n";
+	os << "#include \"houdini/sm/backend/guard_profile.hpp\"\n\n";
+	if (std::begin(hits) == std::end(hits)){
+		os << "//no guarded transitions were recorded\n";
+		return;
+	}
+
+	os << "JANUS_GUARD_PROFILE(" << root_name;
+	for (const GuardHits& entry:hits){
+		os << ",\n\thoudini::sm::GuardHits{" << entry.event << ", " << entry.state << ", "
+			<< entry.position << ", " << entry.hits << "}";
+	}
+	os << ");\n";
+}
+
+} //namespace sm
+} //namespace houdini
+
+/**
+ * @brief Declare the guard profile of the state machine with root state `Root`.
+ * Must be used at global scope, before the state machine is instantiated.
+ */
+#define JANUS_GUARD_PROFILE(Root, ...) \
+	template <> struct houdini::sm::GuardProfile<Root> { \
+		static constexpr houdini::sm::GuardHits hits[] = { __VA_ARGS__ }; \
+	}
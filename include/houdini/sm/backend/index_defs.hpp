@@ -1,5 +1,8 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
 namespace houdini {
 namespace sm {
@@ -10,6 +13,11 @@ using EventIndex = Index;
 using ActionIndex = Index;
 using GuardIndex = Index;
 
+/** @brief Smallest unsigned type that can index `NumStates` states. Used to keep state stacks compact. */
+template <std::size_t NumStates>
+using NarrowStateIndex = std::conditional_t<(NumStates <= std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+	std::conditional_t<(NumStates <= std::numeric_limits<std::uint16_t>::max()), std::uint16_t, StateIndex>>;
+
 
 }
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include "houdini/sm/backend/event_payload.hpp"
+#include "houdini/util/constants.hpp"
+#include "houdini/util/static_queue.hpp"
+#include "houdini/util/types.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Fixed-capacity queue of events raised by a state machine's own actions. 
+ * 
+ * @par Actions receive a reference to the queue of their state machine if they accept it as their last parameter:
+ * `(JEvent, [const Payload&,] Context&, Broker&, ..., InternalEventQueue&)`. Events posted to it are processed 
+ * by `SM::processEvent` as soon as the current transition completes and before it returns, 
+ * ahead of any other event (run-to-completion semantics). The queue never allocates. 
+ */
+class InternalEventQueue {
+	public:
+		InternalEventQueue() = default;
+		InternalEventQueue(const InternalEventQueue&) = delete;
+		InternalEventQueue& operator=(const InternalEventQueue&) = delete;
+
+		/**
+		 * @brief Post an event to the owning state machine. 
+		 * @return false if the queue is full and the event was dropped.
+		 */
+		template <class EventEnum>
+		bool post(EventEnum event){
+			static_assert(std::is_enum_v<EventEnum>, "Event must be an enum type.");
+			if (this->queue.full()){
+				return false;
+			}
+			return this->queue.push(EventBuffer(event));
+		}
+
+		/**
+		 * @brief Post an event with a payload, which is copied into the queue.
+		 * @return false if the queue is full and the event was dropped.
+		 */
+		template <class EventEnum, class Payload>
+		bool post(EventEnum event, const Payload& payload){
+			static_assert(std::is_enum_v<EventEnum>, "Event must be an enum type.");
+			if (this->queue.full()){
+				return false;
+			}
+			return this->queue.push(EventBuffer(event, payload));
+		}
+
+		[[nodiscard]] bool empty() const noexcept {
+			return this->queue.empty();
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return this->queue.size();
+		}
+
+		/** @brief Remove and return the oldest event. The queue must not be empty. */
+		EventBuffer take(){
+			EventBuffer event = this->queue.front();
+			this->queue.pop();
+			return event;
+		}
+
+		void clear() noexcept {
+			this->queue.clear();
+		}
+
+	private:
+		util::StaticQueue<EventBuffer, JANUS_INTERNAL_EVENT_QUEUE_CAPACITY> queue;
+};
+
+} //namespace sm
+} //namespace houdini
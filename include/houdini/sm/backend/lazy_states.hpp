@@ -0,0 +1,188 @@
+#pragma once
+#include "houdini/memory/scoped_resource.hpp"
+#include "houdini/util/mp11.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace houdini {
+namespace sm {
+
+namespace detail {
+template <class State>
+using UsesLazyStatesImpl = decltype(State::lazy_states());
+
+template <class State>
+using IsTransientImpl = decltype(State::transient());
+} //namespace detail
+
+/**
+ * @brief Whether a state machine with root state `Root` constructs its states lazily. 
+ * Opt in by declaring `static constexpr bool lazy_states() { return true; }` in the root state.
+ */
+template <class Root>
+constexpr bool uses_lazy_states(){
+	if constexpr (mp::mp_valid<detail::UsesLazyStatesImpl, Root>::value){
+		return Root::lazy_states();
+	} else {
+		return false;
+	}
+}
+
+/**
+ * @brief Whether the object of a state is destroyed when it is exited, in a state machine with lazy states.
+ * Declare `static constexpr bool transient() { return true; }` in the state to mark it as transient. 
+ */
+template <class State>
+constexpr bool is_transient(){
+	if constexpr (mp::mp_valid<detail::IsTransientImpl, State>::value){
+		return State::transient();
+	} else {
+		return false;
+	}
+}
+
+/**
+ * @brief State storage that reserves a slot for each state type and only constructs a state 
+ * the first time it is needed, from the state machine's memory resource. Transient states are
+ * destroyed again when they are exited.
+ * 
+ * @par States that are never entered, exited or updated, or have no hooks, are never constructed.
+ */
+template <class... States>
+class LazyStates {
+	public:
+		explicit LazyStates(std::pmr::memory_resource* resource_ = std::pmr::get_default_resource()) noexcept 
+		: resource(resource_) {}
+
+		LazyStates(const LazyStates&) = delete;
+		LazyStates& operator=(const LazyStates&) = delete;
+
+		~LazyStates(){
+			this->releaseAll(std::index_sequence_for<States...>{});
+		}
+
+		/** @brief Return the state at index `I`, constructing it if necessary. */
+		template <std::size_t I>
+		auto& acquire(){
+			using T = std::tuple_element_t<I, std::tuple<States...>>;
+			T*& slot = std::get<I>(this->slots);
+			if (!slot){
+				//states that allocate in their constructor can obtain the resource from memory::scoped_resource()
+				memory::ResourceScope scope(this->resource);
+				void* block = this->resource->allocate(sizeof(T), alignof(T));
+				try {
+					slot = ::new (block) T();
+				} catch (...) {
+					this->resource->deallocate(block, sizeof(T), alignof(T));
+					throw;
+				}
+				this->count++;
+				this->bytes += sizeof(T);
+				this->peak_bytes = std::max(this->peak_bytes, this->bytes);
+			}
+			return *slot;
+		}
+
+		/** @brief Destroy the state at index `I` if it has been constructed. */
+		template <std::size_t I>
+		void release() noexcept {
+			using T = std::tuple_element_t<I, std::tuple<States...>>;
+			T*& slot = std::get<I>(this->slots);
+			if (slot){
+				std::destroy_at(slot);
+				this->resource->deallocate(slot, sizeof(T), alignof(T));
+				slot = nullptr;
+				this->count--;
+				this->bytes -= sizeof(T);
+			}
+		}
+
+		template <std::size_t I>
+		bool materialized() const noexcept {
+			return std::get<I>(this->slots) != nullptr;
+		}
+
+		/** @brief Number of states currently constructed. */
+		std::size_t materializedCount() const noexcept {
+			return this->count;
+		}
+
+		/** @brief Bytes currently occupied by constructed states. */
+		std::size_t materializedBytes() const noexcept {
+			return this->bytes;
+		}
+
+		/** @brief Largest number of bytes occupied by constructed states at any one time. */
+		std::size_t peakBytes() const noexcept {
+			return this->peak_bytes;
+		}
+
+	private:
+		template <std::size_t... Is>
+		void releaseAll(std::index_sequence<Is...>) noexcept {
+			(this->release<Is>(), ...);
+		}
+
+		std::tuple<States*...> slots{};
+		std::pmr::memory_resource* resource;
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+		std::size_t peak_bytes = 0;
+};
+
+template <class T>
+struct is_lazy_states : std::false_type {};
+
+template <class... States>
+struct is_lazy_states<LazyStates<States...>> : std::true_type {};
+
+//uniform access to eagerly (std::tuple) and lazily stored states
+
+template <std::size_t I, class... States>
+auto& acquire_state(std::tuple<States...>& states) noexcept {
+	return std::get<I>(states);
+}
+
+template <std::size_t I, class... States>
+auto& acquire_state(LazyStates<States...>& states){
+	return states.template acquire<I>();
+}
+
+template <class... States>
+constexpr std::size_t materialized_states(const std::tuple<States...>&) noexcept {
+	return sizeof...(States);
+}
+
+template <class... States>
+std::size_t materialized_states(const LazyStates<States...>& states) noexcept {
+	return states.materializedCount();
+}
+
+template <class... States>
+constexpr std::size_t state_memory_high_water_mark(const std::tuple<States...>&) noexcept {
+	return sizeof(std::tuple<States...>);
+}
+
+template <class... States>
+std::size_t state_memory_high_water_mark(const LazyStates<States...>& states) noexcept {
+	return states.peakBytes();
+}
+
+} //namespace sm
+} //namespace houdini
+
+template <class... States>
+struct std::tuple_size<houdini::sm::LazyStates<States...>> 
+	: std::integral_constant<std::size_t, sizeof...(States)> {};
+
+template <std::size_t I, class... States>
+struct std::tuple_element<I, houdini::sm::LazyStates<States...>> {
+	using type = std::tuple_element_t<I, std::tuple<States...>>;
+};
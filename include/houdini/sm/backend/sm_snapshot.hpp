@@ -0,0 +1,121 @@
+#pragma once
+#include "houdini/util/type_name.hpp"
+#include "houdini/util/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Format of the blobs written by `SM::snapshot()`. All integers are little endian.
+ *
+ * @code
+ * magic "HSMS" | version u16 | layout hash u64
+ * active state count u16 | active state indices u16...
+ * history stack count u16 | for each: state count u16 | state indices u16...
+ * deferred event count u32 | deferred events u16...
+ * @endcode
+ */
+constexpr std::array<std::byte, 4> SNAPSHOT_MAGIC = {std::byte{'H'}, std::byte{'S'}, std::byte{'M'}, std::byte{'S'}};
+constexpr std::uint16_t SNAPSHOT_VERSION = 1;
+
+namespace detail {
+constexpr std::uint64_t fnv1a(std::string_view text, std::uint64_t hash = 0xcbf29ce484222325ull){
+	for (char c:text){
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+} //namespace detail
+
+/**
+ * @brief Hash of the state map, event enum and depth of a state machine, computed at compile time.
+ * Snapshots can only be restored by a state machine with the same layout hash. The hash is built
+ * from type names, so builds with different compilers may also be rejected.
+ */
+template <class StateMap, class EventEnum, std::size_t Depth>
+constexpr std::uint64_t layout_hash(){
+	std::uint64_t hash = detail::fnv1a(util::type_name<StateMap>());
+	hash = detail::fnv1a(util::type_name<EventEnum>(), hash);
+	return hash ^ Depth;
+}
+
+/** @brief Appends little endian integers to a snapshot blob. */
+class SnapshotWriter {
+	public:
+		explicit SnapshotWriter(JVector<std::byte>& blob_): blob(blob_) {}
+
+		template <class Integer>
+		void write(Integer value){
+			for (std::size_t i = 0; i < sizeof(Integer); i++){
+				this->blob.push_back(static_cast<std::byte>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff));
+			}
+		}
+
+		void writeBytes(const std::byte* data, std::size_t size){
+			this->blob.insert(this->blob.end(), data, data + size);
+		}
+
+	private:
+		JVector<std::byte>& blob;
+};
+
+/** @brief Reads little endian integers from a snapshot blob. Reads past the end fail. */
+class SnapshotReader {
+	public:
+		SnapshotReader(const std::byte* data_, std::size_t size_): data(data_), size(size_) {}
+
+		template <class Integer>
+		bool read(Integer& value){
+			if (this->size - this->offset < sizeof(Integer)){
+				return false;
+			}
+			std::uint64_t result = 0;
+			for (std::size_t i = 0; i < sizeof(Integer); i++){
+				result |= static_cast<std::uint64_t>(this->data[this->offset + i]) << (8 * i);
+			}
+			value = static_cast<Integer>(result);
+			this->offset += sizeof(Integer);
+			return true;
+		}
+
+		bool expectBytes(const std::byte* expected, std::size_t count){
+			if (this->size - this->offset < count){
+				return false;
+			}
+			for (std::size_t i = 0; i < count; i++){
+				if (this->data[this->offset + i] != expected[i]){
+					return false;
+				}
+			}
+			this->offset += count;
+			return true;
+		}
+
+		/** @brief Pointer to the next `count` bytes, which are skipped, or nullptr if there are fewer left. */
+		const std::byte* readBytes(std::size_t count){
+			if (this->size - this->offset < count){
+				return nullptr;
+			}
+			const std::byte* bytes = this->data + this->offset;
+			this->offset += count;
+			return bytes;
+		}
+
+		bool atEnd() const noexcept {
+			return this->offset == this->size;
+		}
+
+	private:
+		const std::byte* data;
+		std::size_t size;
+		std::size_t offset = 0;
+};
+
+} //namespace sm
+} //namespace houdini
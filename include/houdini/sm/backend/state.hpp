@@ -3,6 +3,7 @@
 #include "houdini/sm/backend/pseudo_states.hpp"
 #include "houdini/sm/backend/transition.hpp"
 #include "houdini/sm/backend/event.hpp"
+#include "houdini/sm/backend/timer_event.hpp"
 
 #include "houdini/util/types.hpp"
 
@@ -23,6 +24,12 @@ template <class Type> struct StateBase {
 		return TransitionSE<Type, V> {};
 	}
 
+	template <std::uint32_t Milliseconds, bool Periodic>
+	constexpr auto operator+(const TTimer<Milliseconds, Periodic>&) const {
+		return TransitionSEG<Type, PLACEHOLDER_TIMER_EVENT_VALUE, TimerGuard<Milliseconds, Periodic>> {
+			TimerGuard<Milliseconds, Periodic>{} };
+	}
+
 	template <JEvent Event, class Guard>
 	constexpr auto operator+(const TransitionEG<Event,Guard>& transition) const {
 		return TransitionSEG<Type, Event, Guard> { transition.guard };
@@ -0,0 +1,175 @@
+#pragma once
+#include "houdini/sm/backend/lazy_states.hpp"
+#include "houdini/sm/frontend/base_state.hpp"
+#include "houdini/sm/frontend/behavior.hpp"
+#include "houdini/util/mp11.hpp"
+#include "houdini/util/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Entry, exit and update callbacks of one state in a `Storage` of states (a `std::tuple` or `LazyStates`). A callback is `nullptr` 
+ * if the state type has nothing to do at that point, in which case the state machine skips the call altogether.
+ */
+template <class Storage, class Context, class Broker>
+struct StateHooks {
+	using Hook = void (*)(Storage&, Context&, Broker&);
+	using UpdateHook = void (*)(Storage&, Context&, Broker&, TimePoint);
+
+	Hook entry = nullptr;
+	Hook exit = nullptr;
+	UpdateHook update = nullptr;
+};
+
+/**
+ * @brief Compile-time inspection of state types. A friend of `State`, so it can tell whether 
+ * a state type overrides the private hooks of its base.
+ * 
+ * @par A hook counts as overridden if `&T::hook` does not name the hook declared in `State`. If the override 
+ * is inaccessible, it is conservatively assumed to be overridden. 
+ */
+struct StateAccess {
+	private:
+		struct Inaccessible {};
+
+		template <class T> static auto onEntryType(int) -> decltype(&T::onEntry);
+		template <class T> static Inaccessible onEntryType(...);
+		template <class T> static auto onExitType(int) -> decltype(&T::onExit);
+		template <class T> static Inaccessible onExitType(...);
+		template <class T> static auto updateType(int) -> decltype(&T::update);
+		template <class T> static Inaccessible updateType(...);
+		template <class T> static auto behaviorsType(int) -> std::decay_t<decltype(std::declval<T&>().behaviors)>;
+		template <class T> static void behaviorsType(...);
+
+	public:
+		template <class T, class Context, class Broker>
+		static constexpr bool overridesOnEntry(){
+			return !std::is_same_v<decltype(onEntryType<T>(0)), void (State<Context, Broker>::*)(Context&, Broker&)>;
+		}
+
+		template <class T, class Context, class Broker>
+		static constexpr bool overridesOnExit(){
+			return !std::is_same_v<decltype(onExitType<T>(0)), void (State<Context, Broker>::*)(Context&, Broker&)>;
+		}
+
+		template <class T, class Context, class Broker>
+		static constexpr bool overridesUpdate(){
+			return !std::is_same_v<decltype(updateType<T>(0)), void (State<Context, Broker>::*)(Context&, Broker&)>;
+		}
+
+		template <class T>
+		static constexpr bool hasBehaviors(){
+			return is_behaviors<decltype(behaviorsType<T>(0))>::value;
+		}
+
+		/** @brief Callbacks of the state at index `I` of `Storage`. */
+		template <std::size_t I, class Storage, class Context, class Broker>
+		static constexpr StateHooks<Storage, Context, Broker> hooks(){
+			using T = std::tuple_element_t<I, Storage>;
+			StateHooks<Storage, Context, Broker> state_hooks{};
+			if constexpr (overridesOnEntry<T, Context, Broker>() || hasBehaviors<T>()){
+				state_hooks.entry = &enter<I, Storage, Context, Broker>;
+			}
+			if constexpr (overridesOnExit<T, Context, Broker>() || hasBehaviors<T>() || releasesOnExit<T, Storage, Context, Broker>()){
+				state_hooks.exit = &exit<I, Storage, Context, Broker>;
+			}
+			if constexpr (overridesUpdate<T, Context, Broker>() || hasBehaviors<T>()){
+				state_hooks.update = &update<I, Storage, Context, Broker>;
+			}
+			return state_hooks;
+		}
+
+	private:
+		/** @brief Whether a lazily stored state may have been constructed, and must be destroyed on exit. */
+		template <class T, class Storage, class Context, class Broker>
+		static constexpr bool releasesOnExit(){
+			return is_lazy_states<Storage>::value && is_transient<T>() 
+				&& (overridesOnEntry<T, Context, Broker>() || overridesOnExit<T, Context, Broker>() 
+					|| overridesUpdate<T, Context, Broker>() || hasBehaviors<T>());
+		}
+
+		//hooks are called through the `State` base, where they are accessible. The dynamic type of the
+		//state is known, so the compiler is free to devirtualize the call.
+		template <std::size_t I, class Storage, class Context, class Broker>
+		static void enter(Storage& storage, Context& context, Broker& broker){
+			using T = std::tuple_element_t<I, Storage>;
+			T& state = acquire_state<I>(storage);
+			if constexpr (overridesOnEntry<T, Context, Broker>()){
+				static_cast<State<Context, Broker>&>(state).onEntry(context, broker);
+			}
+			if constexpr (hasBehaviors<T>()){
+				state.behaviors.forEach([&](auto& behavior){ behavior.onEntryImpl(context, broker); });
+			}
+		}
+
+		template <std::size_t I, class Storage, class Context, class Broker>
+		static void exit(Storage& storage, Context& context, Broker& broker){
+			using T = std::tuple_element_t<I, Storage>;
+			if constexpr (overridesOnExit<T, Context, Broker>() || hasBehaviors<T>()){
+				T& state = acquire_state<I>(storage);
+				if constexpr (overridesOnExit<T, Context, Broker>()){
+					static_cast<State<Context, Broker>&>(state).onExit(context, broker);
+				}
+				if constexpr (hasBehaviors<T>()){
+					state.behaviors.forEach([&](auto& behavior){ behavior.onExitImpl(context, broker); });
+				}
+			}
+			if constexpr (releasesOnExit<T, Storage, Context, Broker>()){
+				storage.template release<I>();
+			}
+		}
+
+		template <std::size_t I, class Storage, class Context, class Broker>
+		static void update(Storage& storage, Context& context, Broker& broker, TimePoint now){
+			using T = std::tuple_element_t<I, Storage>;
+			T& state = acquire_state<I>(storage);
+			if constexpr (overridesUpdate<T, Context, Broker>()){
+				static_cast<State<Context, Broker>&>(state).updateImpl(context, broker, now);
+			}
+			if constexpr (hasBehaviors<T>()){
+				state.behaviors.forEach([&](auto& behavior){ behavior.updateImpl(context, broker, now); });
+			}
+		}
+};
+
+namespace detail {
+template <class T>
+using UnderlyingStateT = typename T::type;
+
+template <class Storage, class Context, class Broker, std::size_t... Is>
+constexpr auto makeStateHooks(std::index_sequence<Is...>){
+	return std::array<StateHooks<Storage, Context, Broker>, sizeof...(Is)>{
+		StateAccess::hooks<Is, Storage, Context, Broker>()...
+	};
+}
+} //namespace detail
+
+/**
+ * @brief Tuple holding an object of each state in `StateList` (a list of `TState`s), in order. 
+ */
+template <class StateList>
+using StateStorage = mp::mp_rename<mp::mp_transform<detail::UnderlyingStateT, StateList>, std::tuple>;
+
+/**
+ * @brief `LazyStates` holding a slot for each state in `StateList`, in order. 
+ */
+template <class StateList>
+using LazyStateStorage = mp::mp_rename<mp::mp_transform<detail::UnderlyingStateT, StateList>, LazyStates>;
+
+/**
+ * @brief Hooks of each state in a `StateStorage`, in order. 
+ */
+template <class Storage, class Context, class Broker>
+constexpr auto make_state_hooks(){
+	return detail::makeStateHooks<Storage, Context, Broker>(std::make_index_sequence<std::tuple_size_v<Storage>>{});
+}
+
+} //namespace sm
+} //namespace houdini
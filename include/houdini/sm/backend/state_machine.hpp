@@ -5,8 +5,19 @@
 #include "houdini/sm/backend/fill_dispatch_table.hpp"
 #include "houdini/sm/backend/index.hpp"
 #include "houdini/sm/backend/state.hpp"
+#include "houdini/sm/backend/state_hooks.hpp"
 #include "houdini/sm/backend/traits.hpp"
+#include "houdini/sm/backend/dispatch_map.hpp"
 #include "houdini/sm/backend/dispatch_table.hpp"
+#include "houdini/sm/backend/guard_profile.hpp"
+#include "houdini/sm/backend/transition_trace.hpp"
+#include "houdini/sm/backend/state_metrics.hpp"
+#include "houdini/sm/backend/sm_snapshot.hpp"
+#include "houdini/sm/backend/timed_transitions.hpp"
+#include "houdini/sm/backend/execution_bounds.hpp"
+#include "houdini/sm/backend/completion_transitions.hpp"
+#include "houdini/sm/backend/event_payload.hpp"
+#include "houdini/sm/backend/internal_event_queue.hpp"
 #include "houdini/sm/backend/transition_table_traits.hpp"
 #include "houdini/sm/backend/variant_queue.hpp"
 #include "houdini/sm/backend/collect.hpp"
@@ -22,15 +33,21 @@
 #include "houdini/util/type_name.hpp"
 #include "houdini/util/static_typeid.hpp"
 #include "houdini/util/types.hpp"
+#include "houdini/util/timing_wheel.hpp"
 
 #include "houdini/actor/context.hpp"
 #include "houdini/brokers/message_broker.hpp"
 #include "houdini/util/utility_functions.hpp"
+#include "houdini/memory/allocate_unique.hpp"
+#include "houdini/memory/scoped_resource.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstdint>
 #include <vector>
 #include <iostream>
+#include <ostream>
 #include <tuple>
 #include <memory>
 #include <type_traits>
@@ -56,6 +73,14 @@ enum class SMResult {
  * All transitions are resolved at compile time using template metaprogramming and constexpr control flow.
  * The dispatch table is stored in static global memory and is unique to each state machine type. 
  * 
+ * States and their behaviors are stored in place inside the state machine. All other memory used by
+ * the state machine (dispatch table entries and queues) is obtained from the memory resource of the allocator 
+ * passed on construction, which defaults to `std::pmr::get_default_resource()`.
+ * 
+ * The dispatch table is immutable once the state machine is constructed, and is shared by all copies 
+ * of a state machine. Copying a state machine only copies its active states, history, queues and state objects, 
+ * so that copies can be used to run events speculatively and then thrown away.
+ * 
  * The active state is 
  */
 template <class RootState, class EventEnum, 
@@ -79,28 +104,153 @@ class SM {
 	static constexpr std::size_t NUM_STATES = mp::mp_size<StateMap>::value;
 	static constexpr JEvent NO_EVENT_VALUE = util::enum_max_value<EventEnum>()+1;
 
+	//all states are stored in place, in the order of the state map, unless the root state opts in to lazy states
+	using StateTuple = std::conditional_t<uses_lazy_states<RootState>(), 
+		LazyStateStorage<mp::mp_transform<mp::mp_front, StateMap>>,
+		StateStorage<mp::mp_transform<mp::mp_front, StateMap>>>;
+
+	//entry, exit and update callbacks of each state, resolved at compile time. States that do nothing are skipped.
+	static constexpr std::array<StateHooks<StateTuple, Context, Broker>, NUM_STATES> state_hooks = 
+		make_state_hooks<StateTuple, Context, Broker>();
+
+	//state indices are stored in the smallest type that can hold NUM_STATES
+	using CompactStateIndex = NarrowStateIndex<NUM_STATES>;
+	using StateStack = StaticStack<CompactStateIndex, SM_DEPTH>;
+	using DispatchCell = JVector<NextState<SM_DEPTH, CompactStateIndex>>;
+	using DispatchRow = std::array<DispatchCell, NUM_STATES>;
+
+	//transitions triggered by `after` and `every` timers, each of which has its own event value after NO_EVENT_VALUE
+	using TimedTransitions = mp::mp_unique<mp::mp_filter<IsTimedTransition, Transitions>>;
+	static constexpr std::size_t NUM_TIMERS = mp::mp_size<TimedTransitions>::value;
+	static constexpr std::array<TimerSpec, NUM_TIMERS> timer_specs = make_timer_specs<StateMap, TimedTransitions>();
+	static constexpr TimerIndex<NUM_STATES, NUM_TIMERS> timer_index = make_timer_index<NUM_STATES>(timer_specs);
+
+	//event values that index the dispatch table, including NO_EVENT_VALUE for anonymous transitions
+	//and the event values of the timers
+	static constexpr std::size_t DISPATCH_EVENTS = NO_EVENT_VALUE + 1 + NUM_TIMERS;
+	static constexpr EventSlots<DISPATCH_EVENTS> event_slots = make_event_slots<DISPATCH_EVENTS,
+		mp::mp_append<Transitions, decltype(flattenInternalTransitionTable(root_state))>, TimedTransitions>();
+
+	/** @brief Event value under which `Transition`, one of the transitions of the state machine, is dispatched. */
+	template <class Transition>
+	static constexpr JEvent dispatchEvent(){
+		return dispatch_event<TimedTransitions, Transition>(NO_EVENT_VALUE);
+	}
+
+	//index of the parent of each state, NUM_STATES for the root state
+	static constexpr std::array<StateIndex, NUM_STATES> state_parents = make_state_parents<StateMap>();
+	//names of the states, which copies of the state machine do not need to copy
+	static constexpr std::array<std::string_view, NUM_STATES> state_names = 
+		get_state_names<mp::mp_transform<mp::mp_front, StateMap>, NUM_STATES>();
+	static constexpr std::array<std::size_t, NUM_STATES> state_depths = make_state_depths<StateMap>();
+	static constexpr auto transition_footprints = make_transition_footprints<StateMap, TimedTransitions, 
+		mp::mp_append<Transitions, decltype(flattenInternalTransitionTable(root_state))>>(NO_EVENT_VALUE);
+	/** @brief Upper bounds on the hooks, guards and actions run by a single call to `processEvent`. */
+	static constexpr ExecutionBounds execution_bounds = compute_execution_bounds(state_parents, state_depths,
+		transition_footprints, NO_EVENT_VALUE, SM_DEPTH);
+	static_assert(execution_bounds.bounded, 
+		"Anonymous transitions form a cycle, so processing an event may never end.");
+
+	//whether the anonymous transitions of each state have to be looked up after a transition into it
+	static constexpr std::array<bool, NUM_STATES> completion_states = 
+		make_completion_states(state_parents, transition_footprints, NO_EVENT_VALUE);
+	//states with no entry or exit hooks and no timers, which a chain of anonymous transitions may skip over
+	static constexpr std::array<bool, NUM_STATES> quiet_states = [](){
+		std::array<bool, NUM_STATES> quiet{};
+		for (std::size_t state = 0; state < NUM_STATES; state++){
+			quiet[state] = !state_hooks[state].entry && !state_hooks[state].exit 
+				&& timer_index.offsets[state] == timer_index.offsets[state + 1];
+		}
+		return quiet;
+	}();
+	/** 
+	 * @brief Where the chain of anonymous transitions that are always taken from each state ends, `NUM_STATES` if there is none. 
+	 * The state machine goes straight there, without any dispatch table lookup. History records the active states 
+	 * at every transition, so chains are only followed one transition at a time in state machines with history.
+	 */
+	static constexpr std::array<StateIndex, NUM_STATES> completion_targets = [](){
+		if constexpr (has_history(root_state)){
+			std::array<StateIndex, NUM_STATES> targets{};
+			targets.fill(NUM_STATES);
+			return targets;
+		} else {
+			return make_completion_targets(state_parents, state_depths, transition_footprints, quiet_states, NO_EVENT_VALUE);
+		}
+	}();
+
+	//the sparse layout, with one row per event that is actually used, is selected when it at least halves 
+	//the size of the dispatch table. This is the case for enums with large or sparse values.
+	static constexpr std::size_t DENSE_DISPATCH_BYTES = DISPATCH_EVENTS * sizeof(DispatchRow);
+	static constexpr std::size_t SPARSE_DISPATCH_BYTES = event_slots.rows * sizeof(DispatchRow);
+	static constexpr bool SPARSE_DISPATCH = 2 * SPARSE_DISPATCH_BYTES <= DENSE_DISPATCH_BYTES;
+	static constexpr std::size_t DISPATCH_BYTES = SPARSE_DISPATCH ? SPARSE_DISPATCH_BYTES : DENSE_DISPATCH_BYTES;
+	/** @brief Bytes saved in each state machine by the selected dispatch table layout compared to the dense layout. */
+	static constexpr std::size_t DISPATCH_BYTES_SAVED = DENSE_DISPATCH_BYTES - DISPATCH_BYTES;
+
+	using DispatchMap = std::conditional_t<SPARSE_DISPATCH, 
+		SparseDispatchMap<DispatchRow, DISPATCH_EVENTS, event_slots>,
+		DenseDispatchMap<DispatchRow, DISPATCH_EVENTS>>;
+
+	JAllocator<std::byte> allocator;
 	Context& context;
 	Broker& broker;
-	StaticStack<StateIndex, SM_DEPTH> current_state_indices;
-	StateIndex initial_state;
-	std::array<StaticStack<StateIndex, SM_DEPTH>,
+	StateStack current_state_indices;
+	CompactStateIndex initial_state;
+	std::array<StateStack,
 	 history_size(root_state, NUM_STATES)> history;
-	std::array<std::string_view, NUM_STATES> state_names;
-	std::array<std::unique_ptr<State<Context, Broker>>, NUM_STATES> states;
-	std::array<std::array<std::vector<NextState<SM_DEPTH>>, NUM_STATES>,
-		NO_EVENT_VALUE> dispatch_map;
+	StateTuple states;
+	//shared with copies of the state machine, and only modified while it is not shared
+	std::shared_ptr<const DispatchMap> dispatch_map;
+#ifdef JANUS_GUARD_PROFILING
+	//number of times each guard passed, by dispatch table cell and by position in the cell
+	JVector<std::size_t> guard_hit_offsets;
+	JVector<std::uint32_t> guard_hits;
+#endif
+#ifdef JANUS_METRICS
+	StateMachineMetrics metrics;
+#endif
 	std::size_t current_depth{}; 
 	
 	DeferQueue defer_queue;	
+#ifdef JANUS_TRACING
+	TransitionTracer tracer;
+#endif
+	InternalEventQueue internal_events;
 	std::size_t current_regions{};
+	//armed while their source state is active, once a timing wheel is attached
+	std::array<util::TimerNode, NUM_TIMERS> timers;
+	util::TimingWheel* timing_wheel = nullptr;
+	bool (*timer_observer)(void*, JEvent) = nullptr;
+	void* timer_observer_context = nullptr;
 
 	public:
 		SM(Context& context_, Broker& broker_, OptionalArgs&... optional_args) :
+		SM(std::allocator_arg, JAllocator<std::byte>{}, context_, broker_, optional_args...)
+		{}
+
+		/**
+		 * @brief Construct the state machine, allocating all of its memory from the 
+		 * memory resource of `alloc`. 
+		 */
+		SM(std::allocator_arg_t, const JAllocator<std::byte>& alloc, 
+			Context& context_, Broker& broker_, OptionalArgs&... optional_args) :
+		allocator(alloc),
 		context(context_),
 		broker(broker_),
 		initial_state(1),
 		history(),
-		defer_queue()
+		states(makeStates(alloc)),
+		dispatch_map(std::allocate_shared<DispatchMap>(JAllocator<DispatchMap>(alloc), [&alloc](){
+			return util::generate_array<DispatchCell, NUM_STATES>([&alloc](){ return DispatchCell(alloc); });
+		})),
+#ifdef JANUS_GUARD_PROFILING
+		guard_hit_offsets(alloc),
+		guard_hits(alloc),
+#endif
+#ifdef JANUS_METRICS
+		metrics(NUM_STATES, event_slots.rows, alloc),
+#endif
+		defer_queue(alloc)
 	{
 		static_assert(
 			HasTransitionTable<decltype(root_state)>::value, "Root state has no make_transition_table method defined."
@@ -117,12 +267,82 @@ class SM {
 		
 		//create the state machine dispatch table. This is resolved at compile time.
 		fillDispatchTable(optional_dependency);
-		populateArrays();
+		orderGuardedTransitions();
+		initTimers();
 		//fillInitialStateTable(root_state, this->initial_states);
 		//fillInitialStateTable(root_state, this->history);
 		initCurrentState();		
 	}
 
+	/**
+	 * @brief Copy the state machine. The copy shares the dispatch table, context, broker and optional
+	 * dependencies of `other`, and has its own copy of the active states, history, deferred events and state objects. 
+	 * Events processed by either state machine do not change the states of the other, although their actions 
+	 * act on the same context and broker. 
+	 * 
+	 * @par Metrics, counters, guard hits and trace records are not copied, and copies have no timing wheel or timer observer attached. 
+	 * States must be copy constructible, so state machines with lazy states cannot be copied. 
+	 */
+	SM(const SM& other) :
+		allocator(other.allocator),
+		context(other.context),
+		broker(other.broker),
+		current_state_indices(other.current_state_indices),
+		initial_state(other.initial_state),
+		history(other.history),
+		states(other.states),
+		dispatch_map(other.dispatch_map),
+#ifdef JANUS_GUARD_PROFILING
+		guard_hit_offsets(other.guard_hit_offsets, other.allocator),
+		guard_hits(other.guard_hits.size(), 0, other.allocator),
+#endif
+#ifdef JANUS_METRICS
+		metrics(NUM_STATES, event_slots.rows, other.allocator),
+#endif
+		current_depth(other.current_depth),
+		defer_queue(other.allocator),
+		current_regions(other.current_regions)
+	{
+		static_assert(std::is_copy_constructible_v<StateTuple>, 
+			"All states must be copy constructible to copy a state machine. Lazy states cannot be copied.");
+		other.defer_queue.forEach([this](const EventBuffer& event){ this->defer_queue.push(event); });
+		initTimers();
+	}
+
+	SM& operator=(const SM&) = delete;
+
+	/**
+	 * @brief Arm the timers of the `after` and `every` transitions in `wheel`. The timers of the active states 
+	 * are armed now, and from then on each timer is armed when its source state is entered and cancelled when 
+	 * it is exited. Expired timers are processed as events, when `wheel` is advanced.
+	 * 
+	 * @par The wheel must outlive the state machine, or be detached first.
+	 */
+	void attachTimers(util::TimingWheel& wheel){
+		this->detachTimers();
+		this->timing_wheel = &wheel;
+		this->armActiveTimers();
+	}
+
+	/** 
+	 * @brief Call `observer(observer_context, event)` with the dispatch value of each expired timer, before its 
+	 * transition is taken. The transition is skipped if the observer returns false. Pass nullptr to remove the observer.
+	 */
+	void observeTimers(bool (*observer)(void*, JEvent), void* observer_context){
+		this->timer_observer = observer;
+		this->timer_observer_context = observer_context;
+	}
+
+	/** @brief Cancel all timers. Time-triggered transitions are not taken until a timing wheel is attached again. */
+	void detachTimers(){
+		if (this->timing_wheel){
+			for (util::TimerNode& timer:this->timers){
+				this->timing_wheel->cancel(timer);
+			}
+			this->timing_wheel = nullptr;
+		}
+	}
+
 	/**
 	 * @brief Process an event and trigger a state machine transition (if applicable).
 	 * If there are deferred events from previous transitions, process them now as well. 
@@ -130,20 +350,93 @@ class SM {
 	 * @param event The event to be processed. The state machine recognizes 
 	 * events by their value. 
 	 * 
-	 * @return The result of processing the event. Results from deferred events are ignored. 
+	 * @return The result of processing the event. Results from deferred events and events posted 
+	 * to the internal event queue by actions are ignored. `SMResult::ERROR` if the event is not a value 
+	 * of the enum, or carries a payload, in which case it is not processed.
 	 */
 	SMResult processEvent(EventEnum event){
+		if (!payloadMatches(static_cast<JEvent>(event), nullptr)){
+			return SMResult::ERROR;
+		}
+
+		SMResult result = processEventInternal(static_cast<JEvent>(event), nullptr);
+
+		runToCompletion();
 		
-		SMResult result = processEventInternal(static_cast<JEvent>(event));
+		return result;
+	}
+
+	/**
+	 * @brief Process an event that carries a payload. The payload is not copied: it is passed 
+	 * by const reference to the guards and actions of the transitions triggered by the event.
+	 * 
+	 * @par The payload type must be the one declared for the event with `JANUS_EVENT_PAYLOAD`.
+	 * Otherwise the event is not processed, and `SMResult::ERROR` is returned.
+	 */
+	template <class Payload>
+	SMResult processEvent(EventEnum event, const Payload& payload){
+		if (!payloadMatches(static_cast<JEvent>(event), util::type_id<Payload>())){
+			return SMResult::ERROR;
+		}
+
+		SMResult result = processEventInternal(static_cast<JEvent>(event), std::addressof(payload));
+
+		runToCompletion();
+		
+		return result;
+	}
+
+	/**
+	 * @brief Process an event, together with its payload if it has one, from an `EventBuffer`.
+	 * Returns `SMResult::ERROR`, without processing it, if the payload is not the one declared for the event.
+	 */
+	SMResult processEvent(const EventBuffer& event){
+		if (!payloadMatches(event.id(), event.payloadType())){
+			return SMResult::ERROR;
+		}
+
+		SMResult result = processEventInternal(event.id(), event.payload());
 
-		processDeferredEvents();
+		runToCompletion();
 		
 		return result;
 	}
 
-	void setDependency(OptionalArgs&... optional_args){
+	/** 
+	 * @brief Take the transition of the timer with dispatch value `event`, as if the timer had expired, without
+	 * arming it again. Used to replay the time-triggered transitions of a journal.
+	 */
+	SMResult processTimerEvent(JEvent event){
+		assert(event > NO_EVENT_VALUE && event < DISPATCH_EVENTS && "Not the dispatch value of a timer.");
+
+		SMResult result = processEventInternal(event, nullptr);
+
+		runToCompletion();
+		
+		return result;
+	}
+
+	/** 
+	 * @brief Set the optional dependencies of the actions and guards. Returns false, and changes nothing, if the 
+	 * dispatch table is shared with a copy of the state machine, whose guards and actions would change too.
+	 */
+	bool setDependency(OptionalArgs&... optional_args){
+		if (this->dispatch_map.use_count() != 1){
+			return false;
+		}
 		auto optional_dependency = std::make_tuple(std::ref(optional_args)...);
 		fillDispatchTable(optional_dependency);
+		return true;
+	}
+
+	/** 
+	 * @brief Index of a state, as returned by `currentState()`. Parent states are listed 
+	 * from the innermost outwards, as for `is`.
+	 */
+	template <class State, class... ParentStates> 
+	static constexpr StateIndex indexOf(State, ParentStates... parent_states){
+		using States = mp::mp_push_back<mp::mp_push_front<decltype(detail::makeTypeList(parent_states...)), State>, Root>;
+		return mp::mp_find<StateMap, States>::value;
 	}
 
 	template <class State> bool is(State) {
@@ -162,32 +455,354 @@ class SM {
 		return currentState() == index;
 	}
 	
-	std::string_view currentStateName(){
+	std::string_view currentStateName() const {
 		return state_names[this->current_state_indices.back()];
 	}
 
-	StateIndex currentState(){
+	StateIndex currentState() const {
 		return this->current_state_indices.back();
 	}
+
+	/** @brief Hash of the layout of this state machine, which snapshots must match to be restored. */
+	static constexpr std::uint64_t LAYOUT_HASH = layout_hash<StateMap, EventEnum, SM_DEPTH>();
+
+	/**
+	 * @brief Serialize the active states, the history of each state and the pending deferred events, with 
+	 * their payloads, into a versioned binary blob, which `restore` accepts. The data of the state objects
+	 * is not included.
+	 */
+	JVector<std::byte> snapshot(){
+		JVector<std::byte> blob(this->allocator);
+		SnapshotWriter writer(blob);
+		writer.writeBytes(SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size());
+		writer.write(SNAPSHOT_VERSION);
+		writer.write(LAYOUT_HASH);
+
+		auto write_stack = [&writer](const StateStack& stack){
+			writer.write(static_cast<std::uint16_t>(stack.size()));
+			for (CompactStateIndex index:stack){
+				writer.write(static_cast<std::uint16_t>(index));
+			}
+		};
+		write_stack(this->current_state_indices);
+		writer.write(static_cast<std::uint16_t>(this->history.size()));
+		for (const StateStack& stack:this->history){
+			write_stack(stack);
+		}
+
+		writer.write(static_cast<std::uint32_t>(this->defer_queue.size()));
+		this->defer_queue.forEach([&writer](const EventBuffer& event){
+			writer.write(event.id());
+			if (event.payload()){
+				writer.writeBytes(static_cast<const std::byte*>(event.payload()), payload_sizes<EventEnum, NO_EVENT_VALUE>[event.id()]);
+			}
+		});
+		return blob;
+	}
+
+	/**
+	 * @brief Restore the active states, history and deferred events from a blob written by `snapshot`.
+	 * No entry or exit hooks are run, and the timers of the restored states start again from their full delay. 
+	 * Blobs that are malformed, from another version or from a state machine with a different layout are rejected, 
+	 * as are blobs with more deferred events than the defer queue can hold. In that case false is returned and 
+	 * the state machine is left unchanged.
+	 */
+	bool restore(const std::byte* data, std::size_t size){
+		SnapshotReader reader(data, size);
+		std::uint16_t version = 0;
+		std::uint64_t hash = 0;
+		if (!reader.expectBytes(SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size()) 
+			|| !reader.read(version) || version != SNAPSHOT_VERSION 
+			|| !reader.read(hash) || hash != LAYOUT_HASH){
+			return false;
+		}
+
+		auto read_stack = [&reader](StateStack& stack){
+			std::uint16_t count = 0;
+			if (!reader.read(count) || count > SM_DEPTH){
+				return false;
+			}
+			stack.clear();
+			for (std::uint16_t i = 0; i < count; i++){
+				std::uint16_t index = 0;
+				if (!reader.read(index) || index >= NUM_STATES){
+					return false;
+				}
+				stack.push_back(static_cast<CompactStateIndex>(index));
+			}
+			return true;
+		};
+
+		//each state of a stack must be a child of the one before it, the first one a child of `parent`
+		auto is_path = [](const StateStack& stack, StateIndex parent){
+			for (CompactStateIndex index:stack){
+				if (state_parents[index] != parent){
+					return false;
+				}
+				parent = index;
+			}
+			return true;
+		};
+
+		//the innermost active state must not have children, one of which would be active
+		auto is_leaf = [](StateIndex state){
+			return std::none_of(state_parents.begin(), state_parents.end(), [state](StateIndex parent){ return parent == state; });
+		};
+
+		StateStack active;
+		if (!read_stack(active) || active.empty() || !is_path(active, NUM_STATES) || !is_leaf(active.back())){
+			return false;
+		}
+		std::uint16_t history_count = 0;
+		if (!reader.read(history_count) || history_count != this->history.size()){
+			return false;
+		}
+		decltype(this->history) restored_history{};
+		for (StateIndex state = 0; state < restored_history.size(); state++){
+			if (!read_stack(restored_history[state]) || !is_path(restored_history[state], state)){
+				return false;
+			}
+		}
+
+		std::uint32_t deferred_count = 0;
+		if (!reader.read(deferred_count) || std::size_t{deferred_count} * sizeof(JEvent) > size 
+			|| deferred_count > DeferQueue::capacity()){
+			return false;
+		}
+		JVector<EventBuffer> deferred(this->allocator);
+		for (std::uint32_t i = 0; i < deferred_count; i++){
+			JEvent event = 0;
+			//only events of the enum can be deferred, not anonymous or timer transitions
+			if (!reader.read(event) || event >= NO_EVENT_VALUE){
+				return false;
+			}
+			const std::size_t payload_size = payload_sizes<EventEnum, NO_EVENT_VALUE>[event];
+			const std::byte* payload = reader.readBytes(payload_size);
+			if (!payload){
+				return false;
+			}
+			deferred.emplace_back(event, payload_size ? payload_type_ids<EventEnum, NO_EVENT_VALUE>[event] : nullptr, 
+				payload, payload_size);
+		}
+		if (!reader.atEnd()){
+			return false;
+		}
+
+		this->current_state_indices = active;
+		this->history = restored_history;
+		this->defer_queue.clear();
+		for (const EventBuffer& event:deferred){
+			this->defer_queue.push(event);
+		}
+		this->internal_events.clear();
+#ifdef JANUS_METRICS
+		const std::uint64_t now = util::read_ticks();
+		for (CompactStateIndex index:this->current_state_indices){
+			this->metrics.stateEntered(index, now);
+		}
+#endif
+		this->armActiveTimers();
+		return true;
+	}
+
+	bool restore(const JVector<std::byte>& blob){
+		return this->restore(blob.data(), blob.size());
+	}
+
+	/**
+	 * @brief Make `state` and all of its parents the active states, as `restore` does: no entry or exit hooks are run,
+	 * and the history and deferred events are kept. Meant to set up tests and benchmarks, such as starting 
+	 * from `execution_bounds.worst_state`.
+	 */
+	void activate(StateIndex state){
+		assert(state < NUM_STATES);
+		StateStack active;
+		for (StateIndex index = state; index < NUM_STATES; index = state_parents[index]){
+			active.push_front(static_cast<CompactStateIndex>(index));
+		}
+		this->current_state_indices = active;
+#ifdef JANUS_METRICS
+		const std::uint64_t now = util::read_ticks();
+		for (CompactStateIndex index:this->current_state_indices){
+			this->metrics.stateEntered(index, now);
+		}
+#endif
+		this->armActiveTimers();
+	}
+
+	/** @brief Number of state objects currently constructed. Always `NUM_STATES` unless states are lazy. */
+	std::size_t materializedStates() const {
+		return materialized_states(this->states);
+	}
+
+	/** @brief Largest amount of memory, in bytes, occupied by state objects at any one time. */
+	std::size_t stateMemoryHighWaterMark() const {
+		return state_memory_high_water_mark(this->states);
+	}
+
+#ifdef JANUS_TRACING
+	/** @brief Ring of transition records, to be attached to a `TraceDrainer` running on another thread. */
+	TraceRing& traceRing() noexcept {
+		return this->tracer.ring();
+	}
+
+	/** @brief Number of transition records dropped because the trace ring was full. */
+	std::size_t droppedTraceRecords() const noexcept {
+		return this->tracer.dropped();
+	}
+#endif
+
+#ifdef JANUS_GUARD_PROFILING
+	/** 
+	 * @brief Number of times each guard passed, for every dispatch table cell with more than one 
+	 * guarded transition. Positions refer to the declaration order of the transitions in their cell.
+	 */
+	JVector<GuardHits> guardHits() const {
+		JVector<GuardHits> hits(this->allocator);
+		for (std::size_t event = 0; event < DISPATCH_EVENTS; event++){
+			for (std::size_t state = 0; state < NUM_STATES; state++){
+				const DispatchCell& cell = (*this->dispatch_map)[static_cast<JEvent>(event)][state];
+				if (std::count_if(cell.begin(), cell.end(), [](const auto& entry){ return entry.hasGuard(); }) < 2){
+					continue;
+				}
+				for (std::size_t i = 0; i < cell.size(); i++){
+					if (cell[i].hasGuard()){
+						hits.push_back({static_cast<JEvent>(event), state, cell[i].declared_position, 
+							this->guard_hits[this->guardHitOffset(event, state) + i]});
+					}
+				}
+			}
+		}
+		return hits;
+	}
+
+	/** 
+	 * @brief Write the guard hit counts as a header that declares the guard profile of the root state. 
+	 * When the header is included, guarded transitions that passed more often are evaluated first.
+	 */
+	void writeGuardProfile(std::ostream& os) const {
+		writeGuardProfileHeader(os, util::type_name<RootState>(), this->guardHits());
+	}
+#endif
 	
 	void update(){
+		this->update(SteadyClock::now());
+	}
+
+	/**
+	 * @brief Update all active states as of time `now`. 
+	 * Passing the time explicitly allows the state machine to be driven by a simulated clock.
+	 */
+	void update(TimePoint now){
 		for (StateIndex state_index:this->current_state_indices){
-			this->states[state_index]->updateImpl(this->context, this->broker);
+			if (auto hook = state_hooks[state_index].update){
+#ifdef JANUS_PERF_COUNTERS
+				util::PerfScope perf_scope(util::PerfCounterGroup::thisThread(), this->metrics.updateCounters(state_index));
+#endif
+#ifdef JANUS_METRICS
+				const std::uint64_t start = util::read_ticks();
+				hook(this->states, this->context, this->broker, now);
+				this->metrics.update(state_index).record(util::read_ticks() - start);
+#else
+				hook(this->states, this->context, this->broker, now);
+#endif
+			}
 		}
 	}
 
+#ifdef JANUS_METRICS
+	using LatencySnapshot = StateMachineMetrics::Snapshot;
+
+	/** 
+	 * @brief Latency of the transitions taken on `event` while `state` was the innermost active state, 
+	 * from leaving the first state to entering the last. Safe to call from any thread, 
+	 * as are the other latency accessors.
+	 */
+	LatencySnapshot transitionLatency(StateIndex state, EventEnum event) const {
+		return StateMachineMetrics::snapshot(this->metrics.transition(state, event_slots.slots[static_cast<JEvent>(event)]));
+	}
+
+	LatencySnapshot entryLatency(StateIndex state) const {
+		return StateMachineMetrics::snapshot(this->metrics.entry(state));
+	}
+
+	LatencySnapshot exitLatency(StateIndex state) const {
+		return StateMachineMetrics::snapshot(this->metrics.exit(state));
+	}
+
+	LatencySnapshot updateLatency(StateIndex state) const {
+		return StateMachineMetrics::snapshot(this->metrics.update(state));
+	}
+
+	/** @brief Time spent in `state` each time it was active, recorded when it is exited. */
+	LatencySnapshot dwellTime(StateIndex state) const {
+		return StateMachineMetrics::snapshot(this->metrics.dwellTime(state));
+	}
+#endif
+
+#ifdef JANUS_PERF_COUNTERS
+	/** @brief Whether hardware performance counters could be opened for the calling thread. */
+	bool perfCountersAvailable() const noexcept {
+		return util::PerfCounterGroup::thisThread().available();
+	}
+
+	/** 
+	 * @brief Hardware counters summed over every dispatch of `event` while `state` was the innermost 
+	 * active state, including guards, exits, the action and entries. 
+	 */
+	util::PerfSnapshot dispatchCounters(StateIndex state, EventEnum event) const {
+		return this->metrics.dispatchCounters(state, event_slots.slots[static_cast<JEvent>(event)]).snapshot();
+	}
+
+	/** @brief Hardware counters summed over the calls to the update hook of `state`. */
+	util::PerfSnapshot updateCounters(StateIndex state) const {
+		return this->metrics.updateCounters(state).snapshot();
+	}
+#endif
+
 	private:
-		void populateArrays(){
-			using States = mp::mp_transform<mp::mp_front, StateMap>;
-			for_each_index_mp<States>(
-				[this](auto state, std::size_t index){
-					//all state types are wrapped in TState<>
-					using UnderlyingState = typename decltype(state)::type;
-					//std::cout << "State, name: " << index << ", " << util::type_name<UnderlyingState>() << "\n";
-					this->state_names.at(index) = util::type_name<UnderlyingState>();
-					this->states.at(index) = std::unique_ptr<State<Context,Broker>>(new UnderlyingState);
+		/**
+		 * @brief Construct all states in place. States that allocate in their constructor can obtain 
+		 * the state machine's memory resource from `memory::scoped_resource()`.
+		 */
+		static StateTuple makeStates(const JAllocator<std::byte>& alloc){
+			if constexpr (is_lazy_states<StateTuple>::value){
+				return StateTuple{alloc.resource()};
+			} else {
+				memory::ResourceScope scope(alloc.resource());
+				return StateTuple{};
+			}
+		}
+
+		/** 
+		 * @brief Apply the guard profile of the root state, if one is declared. When profiling, 
+		 * also record the declared position of each transition so that hits can be reported against it.
+		 */
+		void orderGuardedTransitions(){
+#ifdef JANUS_GUARD_PROFILING
+			this->guard_hit_offsets.assign(1, 0);
+			for (std::size_t event = 0; event < DISPATCH_EVENTS; event++){
+				for (DispatchCell& cell:this->mutableDispatchMap()[static_cast<JEvent>(event)]){
+					for (std::size_t i = 0; i < cell.size(); i++){
+						cell[i].declared_position = static_cast<std::uint16_t>(i);
+					}
+					this->guard_hit_offsets.push_back(this->guard_hit_offsets.back() + cell.size());
 				}
-			);
+			}
+			this->guard_hits.assign(this->guard_hit_offsets.back(), 0);
+#endif
+			if constexpr (has_guard_profile<RootState>()){
+				const auto& profile = GuardProfile<RootState>::hits;
+				for (std::size_t i = 0; i < std::size(profile); i++){
+					const bool sorted = std::any_of(std::begin(profile), std::begin(profile) + i, [&](const GuardHits& entry){
+						return entry.event == profile[i].event && entry.state == profile[i].state;
+					});
+					if (!sorted && profile[i].event < DISPATCH_EVENTS && profile[i].state < NUM_STATES){
+						sortByGuardProfile<RootState>(this->mutableDispatchMap()[profile[i].event][profile[i].state], 
+							profile[i].event, profile[i].state);
+					}
+				}
+			}
 		}
 
 		/**
@@ -199,11 +814,18 @@ class SM {
 		 * of results is returned as a `std::deque` of an `EventVariant` contains a `NextState<Event>`. 
 		 * 
 		 * @param event The event to be processed. 
+		 * @param payload The payload of the event, or `nullptr` if it has none. 
 		 */
-		SMResult processEventInternal(JEvent&& event) {
+		SMResult processEventInternal(JEvent event, const void* payload) {
 			bool all_guards_failed = true;
 			bool all_transitions_invalid = true;
-
+#ifdef JANUS_TRACING
+			this->tracer.beginEvent();
+#endif
+#ifdef JANUS_PERF_COUNTERS
+			util::PerfScope perf_scope(util::PerfCounterGroup::thisThread(), 
+				this->metrics.dispatchCounters(current_state_indices.back(), event_slots.slots[event]));
+#endif
 
 			auto& results = getDispatchTableEntry(event);
 
@@ -214,20 +836,28 @@ class SM {
 			for (auto& result: results){
 
 				if (result.defer){
-					return SMResult::DEFERRED;
+					return this->deferEvent(event, payload) ? SMResult::DEFERRED : SMResult::ERROR;
 				}
 
-				if (!result.transition->executeGuard(event)) {
+#ifdef JANUS_TRACING
+				if (result.hasGuard()){
+					this->tracer.guardEvaluated();
+				}
+#endif
+				if (!result.executeGuard(event, payload)) {
 					all_transitions_invalid = false;
 					continue;
 				}
+#ifdef JANUS_GUARD_PROFILING
+				this->countGuardHit(event, static_cast<std::size_t>(&result - results.data()));
+#endif
 				// std::cout << "Valid: " << result.valid << std::endl;
 				// std::cout << "Size: " << result.destination_states.size() << std::endl;
 				//std::cout << "Final destination: " << result.destination_states.back() << std::endl;
 
 				all_transitions_invalid = false;
 				all_guards_failed = false;
-				updathoudiniAndExecuteCallbacks(event, result);
+				updathoudiniAndExecuteCallbacks(event, result, payload);
 				
 				break;
 			}
@@ -243,8 +873,102 @@ class SM {
 			return SMResult::SUCCESS;
 		}
 
-		void updathoudiniAndExecuteCallbacks(JEvent event, const NextState<SM_DEPTH>& result){
+		void enterState(StateIndex index){
+#ifdef JANUS_METRICS
+			const std::uint64_t start = util::read_ticks();
+			this->metrics.stateEntered(index, start);
+			if (auto hook = state_hooks[index].entry){
+				hook(this->states, this->context, this->broker);
+				this->metrics.entry(index).record(util::read_ticks() - start);
+			}
+#else
+			if (auto hook = state_hooks[index].entry){
+				hook(this->states, this->context, this->broker);
+			}
+#endif
+			if constexpr (NUM_TIMERS > 0){
+				if (this->timing_wheel){
+					for (std::size_t i = timer_index.offsets[index]; i < timer_index.offsets[index + 1]; i++){
+						this->armTimer(timer_index.timers[i]);
+					}
+				}
+			}
+		}
+
+		void exitState(StateIndex index){
+			if constexpr (NUM_TIMERS > 0){
+				if (this->timing_wheel){
+					for (std::size_t i = timer_index.offsets[index]; i < timer_index.offsets[index + 1]; i++){
+						this->timing_wheel->cancel(this->timers[timer_index.timers[i]]);
+					}
+				}
+			}
+#ifdef JANUS_METRICS
+			const std::uint64_t start = util::read_ticks();
+			this->metrics.stateExited(index, start);
+			if (auto hook = state_hooks[index].exit){
+				hook(this->states, this->context, this->broker);
+				this->metrics.exit(index).record(util::read_ticks() - start);
+			}
+#else
+			if (auto hook = state_hooks[index].exit){
+				hook(this->states, this->context, this->broker);
+			}
+#endif
+		}
+
+		void initTimers(){
+			for (std::size_t i = 0; i < NUM_TIMERS; i++){
+				this->timers[i].callback = &SM::onTimer;
+				this->timers[i].context = this;
+				this->timers[i].id = i;
+			}
+		}
+
+		void armTimer(std::size_t timer){
+			this->timing_wheel->arm(this->timers[timer], std::chrono::milliseconds(timer_specs[timer].duration_ms));
+		}
+
+		/** @brief Arm the timers of the active states, and cancel all others. */
+		void armActiveTimers(){
+			if (!this->timing_wheel){
+				return;
+			}
+			for (util::TimerNode& timer:this->timers){
+				this->timing_wheel->cancel(timer);
+			}
+			for (CompactStateIndex index:this->current_state_indices){
+				for (std::size_t i = timer_index.offsets[index]; i < timer_index.offsets[index + 1]; i++){
+					this->armTimer(timer_index.timers[i]);
+				}
+			}
+		}
+
+		/** 
+		 * @brief Take the transition of an expired timer through the dispatch table, as for any other event. 
+		 * Periodic timers are armed again first, so that the transition may cancel them.
+		 */
+		static void onTimer(util::TimerNode& timer){
+			SM& state_machine = *static_cast<SM*>(timer.context);
+			if (timer_specs[timer.id].periodic){
+				state_machine.armTimer(timer.id);
+			}
+			const JEvent event = static_cast<JEvent>(NO_EVENT_VALUE + 1 + timer.id);
+			if (state_machine.timer_observer && !state_machine.timer_observer(state_machine.timer_observer_context, event)){
+				return;
+			}
+			state_machine.processTimerEvent(event);
+		}
+
+		void updathoudiniAndExecuteCallbacks(JEvent event, const NextState<SM_DEPTH, CompactStateIndex>& result, const void* payload){
 			//std::cout << "Updating and executing callbacks." << std::endl;
+#ifdef JANUS_TRACING
+			this->tracer.beginTransition(current_state_indices.back());
+#endif
+#ifdef JANUS_METRICS
+			const std::uint64_t transition_start = util::read_ticks();
+			const StateIndex transition_from = current_state_indices.back();
+#endif
 			
 			auto destination_stack = result.destination_states;
 			
@@ -259,12 +983,12 @@ class SM {
 				
 				if (result.history){
 					StateIndex lowest_destination = destination_stack.back();
-					for (StateIndex index:this->history[lowest_destination]){
+					for (CompactStateIndex index:this->history[lowest_destination]){
 						destination_stack.push_back(index);
 					}
 				}
 			}
-			StateIndex back_state = current_state_indices.back();
+			CompactStateIndex back_state = current_state_indices.back();
 			auto back_dest_state_iter = destination_stack.crbegin();
 			
 			//TODO: make sure order of activation is correct
@@ -272,7 +996,7 @@ class SM {
 			if (stack_size_diff > 0){ 
 				//current state is deeper in the hierarchy
 				for (auto i = stack_size_diff; i > 0; --i){
-					this->states[back_state]->onExitImpl(this->context, this->broker);
+					this->exitState(back_state);
 					current_state_indices.pop();
 					back_state = current_state_indices.back();
 				}
@@ -286,20 +1010,32 @@ class SM {
 			}
 
 			while (back_state != *back_dest_state_iter){
-				this->states[back_state]->onExitImpl(this->context, this->broker);
+				this->exitState(back_state);
 				current_state_indices.pop(); 
 				back_state = current_state_indices.back();
 				back_dest_state_iter++;
 			}
-			result.transition->executeAction(event);
+#ifdef JANUS_TRACING
+			this->tracer.exited();
+#endif
+			result.executeAction(event, payload, this->internal_events);
+#ifdef JANUS_TRACING
+			this->tracer.actionDone();
+#endif
 
 			while(back_dest_state_iter != destination_stack.crbegin()) { 
 				//TODO: this currently fails if the state machine is supposed to transition to the same state. 
 				back_dest_state_iter--;				
 				back_state = *back_dest_state_iter;
 				current_state_indices.push_back(back_state);
-				this->states[back_state]->onEntryImpl(this->context, this->broker);
+				this->enterState(back_state);
 			}
+#ifdef JANUS_TRACING
+			this->tracer.endTransition(event, current_state_indices.back());
+#endif
+#ifdef JANUS_METRICS
+			this->metrics.transition(transition_from, event_slots.slots[event]).record(util::read_ticks() - transition_start);
+#endif
 
 		}
 
@@ -313,7 +1049,19 @@ class SM {
 				while (true){
 					bool all_guards_failed = true;
 
+					const StateIndex leaf = this->current_state_indices.back();
+					if (!completion_states[leaf]){
+						return;
+					}
+
 					JEvent event = NO_EVENT_VALUE;
+#ifdef JANUS_TRACING
+					this->tracer.beginEvent();
+#endif
+					if (completion_targets[leaf] < NUM_STATES){
+						this->completeTo(completion_targets[leaf]);
+						continue;
+					}
 
 					auto& results = getDispatchTableEntry(event);
 
@@ -322,11 +1070,19 @@ class SM {
 					}
 
 					for (auto& result: results){
-						if (!result.transition->executeGuard(event)){
+#ifdef JANUS_TRACING
+						if (result.hasGuard()){
+							this->tracer.guardEvaluated();
+						}
+#endif
+						if (!result.executeGuard(event, nullptr)){
 							continue;
 						}
+#ifdef JANUS_GUARD_PROFILING
+						this->countGuardHit(event, static_cast<std::size_t>(&result - results.data()));
+#endif
 
-						updathoudiniAndExecuteCallbacks(event, result);
+						updathoudiniAndExecuteCallbacks(event, result, nullptr);
 						all_guards_failed = false;
 						break;
 					}
@@ -338,14 +1094,58 @@ class SM {
 			}
 		}
 
+		/** @brief Follow a chain of anonymous transitions that are always taken in a single transition to `target`. */
+		void completeTo(StateIndex target){
+			NextState<SM_DEPTH, CompactStateIndex> completion;
+			for (StateIndex index = target; index < NUM_STATES; index = state_parents[index]){
+				completion.destination_states.push_front(static_cast<CompactStateIndex>(index));
+			}
+			completion.valid = true;
+			updathoudiniAndExecuteCallbacks(NO_EVENT_VALUE, completion, nullptr);
+		}
+
+		/**
+		 * @brief Process the events posted by actions to the internal event queue, including those posted
+		 * while doing so, then any deferred events. Internal events take priority over all other events. 
+		 */
+		void runToCompletion(){
+			while (!this->internal_events.empty()){
+				//copy the event out, as processing it may post further events
+				const EventBuffer event = this->internal_events.take();
+				//events posted without their declared payload are dropped
+				if (payloadMatches(event.id(), event.payloadType())){
+					this->processEventInternal(event.id(), event.payload());
+				}
+			}
+			processDeferredEvents();
+		}
+
 		void processDeferredEvents() {
 			if constexpr (HasDeferredEvents<decltype(root_state)>::value){
 				if (!this->defer_queue.empty()){
-					this->defer_queue.visit([this](auto event){this->processEventInternal(event);});
+					this->defer_queue.visit([this](const EventBuffer& event){
+						this->processEventInternal(event.id(), event.payload());
+					});
 				}
 			}
 		}
 
+		/** 
+		 * @brief Queue a deferred event with a copy of its payload. Events are only queued when the root state 
+		 * declares deferred events, as the queue is only processed then. Returns false if the queue is full.
+		 */
+		bool deferEvent(JEvent event, const void* payload){
+			if constexpr (HasDeferredEvents<decltype(root_state)>::value){
+				assert(event < NO_EVENT_VALUE && "Only events of the enum can be deferred.");
+				return this->defer_queue.push(EventBuffer(event, payload ? payload_type_ids<EventEnum, NO_EVENT_VALUE>[event] : nullptr,
+					payload, payload ? payload_sizes<EventEnum, NO_EVENT_VALUE>[event] : 0));
+			} else {
+				(void) event;
+				(void) payload;
+				return true;
+			}
+		}
+
 		/**
 		 * @brief Retrieve transition information, given the current active state
 		 * and the event code.  This transition information contains all the information
@@ -353,13 +1153,46 @@ class SM {
 		 */
 		constexpr auto getDispatchTableEntry(JEvent event) -> decltype(auto) {
 			//std::cout <<  "Current state and event: " << this->currentStateName() << "(" << current_state_indices.back() << ")" << ", " << event << std::endl;
-			return this->dispatch_map[event][this->current_state_indices.back()];
+			return (*this->dispatch_map)[event][this->current_state_indices.back()];
+		}
+
+		/** @brief The dispatch table, to be filled. It must not be shared with a copy of the state machine yet. */
+		DispatchMap& mutableDispatchMap(){
+			assert(this->dispatch_map.use_count() == 1 && "The dispatch table is shared with a copy of the state machine.");
+			//allocated as a non-const DispatchMap by the constructor
+			return const_cast<DispatchMap&>(*this->dispatch_map);
+		}
+
+#ifdef JANUS_GUARD_PROFILING
+		/** @brief Index in `guard_hits` of the first transition of a dispatch table cell. */
+		std::size_t guardHitOffset(std::size_t event, std::size_t state) const {
+			return this->guard_hit_offsets[event * NUM_STATES + state];
+		}
+
+		/** @brief Count a passed guard, at `position` in the cell of `event` and the innermost active state. */
+		void countGuardHit(JEvent event, std::size_t position){
+			this->guard_hits[this->guardHitOffset(event, this->current_state_indices.back()) + position]++;
+		}
+#endif
+
+		/** @brief Whether `payload_type` is the payload type declared for `event` (`void` if none was declared). */
+		static bool payloadMatches(JEvent event, util::TypeidType payload_type){
+			if (event >= NO_EVENT_VALUE){
+				return false;
+			}
+			const util::TypeidType expected = payload_type_ids<EventEnum, NO_EVENT_VALUE>[event];
+			return payload_type ? expected == payload_type : expected == util::type_id<void>();
 		}
 
 		constexpr void initCurrentState(){
 
 			this->current_state_indices.push_back(0);
 			this->current_state_indices.push_back(this->initial_state);
+#ifdef JANUS_METRICS
+			const std::uint64_t now = util::read_ticks();
+			this->metrics.stateEntered(0, now);
+			this->metrics.stateEntered(this->initial_state, now);
+#endif
 			if constexpr (has_history(root_state)){
 			//TODO: need to fill history with appropriate initial states.
 
@@ -368,11 +1201,12 @@ class SM {
 
 		template <class OptionalDependency>
 		void fillDispatchTable(OptionalDependency& optional_dependency){
+			DispatchMap& table = this->mutableDispatchMap();
 			fillDispatchTableWithInternalTransitions(
-				*this, optional_dependency);
+				*this, table, optional_dependency);
 			fillDispatchTableWithExternalTransitions(
-				*this, optional_dependency);
-			fillDispatchTableWithDeferredEvents(*this, this->dispatch_map, optional_dependency);
+				*this, table, optional_dependency);
+			fillDispatchTableWithDeferredEvents(*this, table, optional_dependency);
 		}
 
 };
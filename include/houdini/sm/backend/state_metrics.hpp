@@ -0,0 +1,105 @@
+#pragma once
+#include "houdini/util/constants.hpp"
+#include "houdini/util/latency_histogram.hpp"
+#include "houdini/util/perf_counters.hpp"
+#include "houdini/util/tick_clock.hpp"
+#include "houdini/util/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Latency histograms of one state machine, in ticks of `util::read_ticks()`. 
+ * There is one histogram per dispatch table cell, indexed by state and event row,
+ * and one histogram per state for entry, exit, update and dwell time. All of them are 
+ * allocated when the state machine is constructed.
+ * 
+ * @par With JANUS_PERF_COUNTERS, hardware counter totals are also kept for each dispatch table cell
+ * and for the update hook of each state.
+ * 
+ * @par Histograms are written by the thread running the state machine and may be read 
+ * by any other thread.
+ */
+class StateMachineMetrics {
+	public:
+		using Histogram = util::LatencyHistogram;
+		using Snapshot = Histogram::Snapshot;
+
+		StateMachineMetrics(std::size_t num_states, std::size_t num_event_rows, const JAllocator<std::byte>& alloc):
+		event_rows(num_event_rows),
+		transitions(num_states * num_event_rows, alloc),
+		entries(num_states, alloc),
+		exits(num_states, alloc),
+		updates(num_states, alloc),
+		dwell(num_states, alloc),
+		entered_at(num_states, 0, alloc)
+#ifdef JANUS_PERF_COUNTERS
+		, dispatch_counters(num_states * num_event_rows, alloc),
+		update_counters(num_states, alloc)
+#endif
+		{}
+
+		Histogram& transition(std::size_t state, std::size_t event_row){
+			return this->transitions[state * this->event_rows + event_row];
+		}
+
+		const Histogram& transition(std::size_t state, std::size_t event_row) const {
+			return this->transitions[state * this->event_rows + event_row];
+		}
+
+		Histogram& entry(std::size_t state){ return this->entries[state]; }
+		const Histogram& entry(std::size_t state) const { return this->entries[state]; }
+
+		Histogram& exit(std::size_t state){ return this->exits[state]; }
+		const Histogram& exit(std::size_t state) const { return this->exits[state]; }
+
+		Histogram& update(std::size_t state){ return this->updates[state]; }
+		const Histogram& update(std::size_t state) const { return this->updates[state]; }
+
+		const Histogram& dwellTime(std::size_t state) const { return this->dwell[state]; }
+
+		void stateEntered(std::size_t state, std::uint64_t now){
+			this->entered_at[state] = now;
+		}
+
+		void stateExited(std::size_t state, std::uint64_t now){
+			this->dwell[state].record(now - this->entered_at[state]);
+		}
+
+#ifdef JANUS_PERF_COUNTERS
+		util::PerfTotals& dispatchCounters(std::size_t state, std::size_t event_row){
+			return this->dispatch_counters[state * this->event_rows + event_row];
+		}
+
+		const util::PerfTotals& dispatchCounters(std::size_t state, std::size_t event_row) const {
+			return this->dispatch_counters[state * this->event_rows + event_row];
+		}
+
+		util::PerfTotals& updateCounters(std::size_t state){ return this->update_counters[state]; }
+		const util::PerfTotals& updateCounters(std::size_t state) const { return this->update_counters[state]; }
+#endif
+
+		/** @brief Take a snapshot of `histogram`, with values converted from ticks to nanoseconds. */
+		static Snapshot snapshot(const Histogram& histogram){
+			return histogram.snapshot(1000.0 / util::ticks_per_microsecond());
+		}
+
+	private:
+		std::size_t event_rows;
+		JVector<Histogram> transitions;
+		JVector<Histogram> entries;
+		JVector<Histogram> exits;
+		JVector<Histogram> updates;
+		JVector<Histogram> dwell;
+		JVector<std::uint64_t> entered_at;
+#ifdef JANUS_PERF_COUNTERS
+		JVector<util::PerfTotals> dispatch_counters;
+		JVector<util::PerfTotals> update_counters;
+#endif
+};
+
+} //namespace sm
+} //namespace houdini
@@ -0,0 +1,66 @@
+#pragma once
+#include "houdini/sm/backend/index.hpp"
+#include "houdini/sm/backend/resolve_state.hpp"
+#include "houdini/sm/backend/timer_event.hpp"
+
+#include "houdini/util/mp11.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace houdini {
+namespace sm {
+
+/** @brief The state whose entry arms a timer, and the delay of the timer. */
+struct TimerSpec {
+	StateIndex source;
+	std::uint32_t duration_ms;
+	bool periodic;
+};
+
+namespace detail {
+template <class StateMap, template <class...> class List, class... Transitions>
+constexpr std::array<TimerSpec, sizeof...(Transitions)> makeTimerSpecs(List<Transitions...>){
+	return {TimerSpec{
+		getCombinedStateIndex(StateMap{}, resolveSrcParents(Transitions{}), resolveSrc(Transitions{})),
+		Transitions::guard_t::duration_ms,
+		Transitions::guard_t::periodic}...};
+}
+} //namespace detail
+
+/**
+ * @brief Timer of each transition in `TimedTransitionList`, a type list of time-triggered transitions,
+ * with the index of its source state in `StateMap`.
+ */
+template <class StateMap, class TimedTransitionList>
+constexpr auto make_timer_specs(){
+	return detail::makeTimerSpecs<StateMap>(TimedTransitionList{});
+}
+
+/** @brief Timers grouped by source state: the timers of state `i` are `timers[offsets[i]]` to `timers[offsets[i + 1] - 1]`. */
+template <std::size_t NumStates, std::size_t NumTimers>
+struct TimerIndex {
+	std::array<std::size_t, NumStates + 1> offsets{};
+	std::array<std::size_t, NumTimers> timers{};
+};
+
+template <std::size_t NumStates, std::size_t NumTimers>
+constexpr TimerIndex<NumStates, NumTimers> make_timer_index(const std::array<TimerSpec, NumTimers>& specs){
+	TimerIndex<NumStates, NumTimers> index{};
+	for (const TimerSpec& spec:specs){
+		index.offsets[spec.source + 1]++;
+	}
+	for (std::size_t state = 0; state < NumStates; state++){
+		index.offsets[state + 1] += index.offsets[state];
+	}
+	std::array<std::size_t, NumStates> filled{};
+	for (std::size_t timer = 0; timer < NumTimers; timer++){
+		const StateIndex source = specs[timer].source;
+		index.timers[index.offsets[source] + filled[source]++] = timer;
+	}
+	return index;
+}
+
+} //namespace sm
+} //namespace houdini
@@ -0,0 +1,87 @@
+#pragma once
+#include "houdini/sm/backend/fwd_decl.hpp"
+#include "houdini/sm/backend/pseudo_states.hpp"
+#include "houdini/sm/backend/event.hpp"
+
+#include "houdini/util/mp11.hpp"
+#include "houdini/util/types.hpp"
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace houdini {
+namespace sm {
+
+//event value of all time-triggered transitions in the transition table. Each of them is given
+//its own dispatch table row after the anonymous transitions, see `dispatch_event`.
+constexpr JEvent PLACEHOLDER_TIMER_EVENT_VALUE = JEVENT_MAX-2;
+
+/**
+ * @brief Guard of a time-triggered transition. It carries the delay of the timer in its type,
+ * and wraps the guard written in the transition table, if any.
+ */
+template <std::uint32_t Milliseconds, bool Periodic, class Guard = NoGuard>
+struct TimerGuard {
+	using guard_t = Guard;
+	static constexpr std::uint32_t duration_ms = Milliseconds;
+	static constexpr bool periodic = Periodic;
+
+	template <class... Args>
+	auto operator()(Args&&... args) -> decltype(std::declval<Guard&>()(std::forward<Args>(args)...)) {
+		return this->guard(std::forward<Args>(args)...);
+	}
+
+	Guard guard{};
+};
+
+template <class T> struct is_timer_guard : std::false_type {};
+
+template <std::uint32_t Milliseconds, bool Periodic, class Guard>
+struct is_timer_guard<TimerGuard<Milliseconds, Periodic, Guard>> : std::true_type {};
+
+/**
+ * @brief Event source of a time-triggered transition, used in place of an event in the transition table.
+ * The timer is armed when the source state is entered and cancelled when it is exited.
+ * Periodic timers are armed again each time they fire.
+ */
+template <std::uint32_t Milliseconds, bool Periodic>
+struct TTimer {
+	static_assert(Milliseconds > 0, "Timer duration must be at least 1ms.");
+
+	template <class Guard> constexpr auto operator[](const Guard& guard) const {
+		return TransitionEG<PLACEHOLDER_TIMER_EVENT_VALUE, TimerGuard<Milliseconds, Periodic, Guard>>{
+			TimerGuard<Milliseconds, Periodic, Guard>{guard}};
+	}
+
+	template <class Action> constexpr auto operator/(const Action& action) const {
+		return TransitionEGA<PLACEHOLDER_TIMER_EVENT_VALUE, TimerGuard<Milliseconds, Periodic>, Action>{
+			TimerGuard<Milliseconds, Periodic>{}, action};
+	}
+};
+
+/** @brief Transition taken `Milliseconds` after the source state was entered, if it is still active. */
+template <std::uint32_t Milliseconds> constexpr TTimer<Milliseconds, false> after {};
+
+/** @brief Transition taken every `Milliseconds` while the source state is active. */
+template <std::uint32_t Milliseconds> constexpr TTimer<Milliseconds, true> every {};
+
+template <class Transition>
+using IsTimedTransition = is_timer_guard<typename Transition::guard_t>;
+
+/**
+ * @brief Event value under which `Transition` is stored in the dispatch table of a state machine whose
+ * anonymous transitions use `no_event_value`. Anonymous transitions use `no_event_value` itself, and the
+ * time-triggered transitions in `TimedTransitions` the values that follow it, in order.
+ */
+template <class TimedTransitions, class Transition>
+constexpr JEvent dispatch_event(JEvent no_event_value){
+	if constexpr (IsTimedTransition<Transition>::value){
+		return static_cast<JEvent>(no_event_value + 1 + mp::mp_find<TimedTransitions, Transition>::value);
+	} else {
+		return Transition::event() == PLACEHOLDER_NO_EVENT_VALUE ? no_event_value : Transition::event();
+	}
+}
+
+} //namespace sm
+} //namespace houdini
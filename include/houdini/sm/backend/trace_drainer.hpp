@@ -0,0 +1,154 @@
+#pragma once
+#include "houdini/sm/backend/transition_trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Layout of a binary trace file: a `TraceFileHeader` followed by `TraceFileRecord`s.
+ * The file is written and read on the same machine, so records are stored as they are laid out in memory.
+ */
+struct TraceFileHeader {
+	char magic[4] = {'H', 'T', 'R', 'C'};
+	std::uint32_t version = 1;
+	double ticks_per_us = 1.0;
+};
+
+struct TraceFileRecord {
+	//index of the traced state machine, in the order the rings were attached to the drainer
+	std::uint32_t source;
+	TransitionRecord record;
+};
+
+/**
+ * @brief Drains the trace rings of one or more state machines into a binary trace file.
+ * `start()` drains periodically on a background thread; `drain()` can also be called directly.
+ */
+class TraceDrainer {
+	public:
+		explicit TraceDrainer(const std::string& path, std::chrono::milliseconds period_ = std::chrono::milliseconds(10))
+		: file(path, std::ios::binary | std::ios::trunc), period(period_) {
+			TraceFileHeader header;
+			header.ticks_per_us = util::ticks_per_microsecond();
+			this->file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		TraceDrainer(const TraceDrainer&) = delete;
+		TraceDrainer& operator=(const TraceDrainer&) = delete;
+
+		~TraceDrainer(){
+			this->stop();
+		}
+
+		/** @brief Add a ring to drain. Must be called before `start()`. */
+		void attach(TraceRing& ring){
+			this->rings.push_back(&ring);
+		}
+
+		void start(){
+			this->running = true;
+			this->thread = std::thread([this](){
+				while (this->running.load(std::memory_order_relaxed)){
+					this->drain();
+					std::this_thread::sleep_for(this->period);
+				}
+			});
+		}
+
+		/** @brief Stop the background thread, then write out any remaining records. */
+		void stop(){
+			this->running = false;
+			if (this->thread.joinable()){
+				this->thread.join();
+			}
+			this->drain();
+		}
+
+		/** @brief Write all buffered records to the file. Returns the number of records written. */
+		std::size_t drain(){
+			std::size_t written = 0;
+			TraceFileRecord entry{};
+			for (std::size_t i = 0; i < this->rings.size(); i++){
+				entry.source = static_cast<std::uint32_t>(i);
+				while (this->rings[i]->pop(entry.record)){
+					this->file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+					written++;
+				}
+			}
+			this->file.flush();
+			return written;
+		}
+
+		bool good() const {
+			return this->file.good();
+		}
+
+	private:
+		std::ofstream file;
+		std::vector<TraceRing*> rings;
+		std::chrono::milliseconds period;
+		std::atomic<bool> running{false};
+		std::thread thread;
+};
+
+/**
+ * @brief Convert a binary trace file to the Chrome trace event format, which can be viewed
+ * in chrome://tracing or Perfetto. Each transition becomes three consecutive slices (exit, action
+ * and entry) on the thread row of its state machine. Returns false if `in` is not a trace file.
+ */
+inline bool convertTraceToChromeJson(std::istream& in, std::ostream& out){
+	TraceFileHeader header;
+	const TraceFileHeader expected;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| !std::equal(std::begin(header.magic), std::end(header.magic), std::begin(expected.magic))
+		|| header.version != expected.version){
+		return false;
+	}
+
+	auto to_us = [&header](double ticks){ return ticks / header.ticks_per_us; };
+	bool first = true;
+	std::uint64_t origin = 0;
+
+	auto slice = [&out, &first](const char* phase, const TraceFileRecord& entry, double ts, double dur){
+		const TransitionRecord& record = entry.record;
+		out << (first ? "\n" : ",\n");
+		first = false;
+		out << "{\"name\":\"" << phase << "\",\"cat\":\"transition\",\"ph\":\"X\",\"pid\":0,\"tid\":" << entry.source
+			<< ",\"ts\":" << ts << ",\"dur\":" << dur
+			<< ",\"args\":{\"event\":" << record.event << ",\"from\":" << record.from << ",\"to\":" << record.to
+			<< ",\"guards\":" << record.guards_evaluated << "}}";
+	};
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	TraceFileRecord entry;
+	while (in.read(reinterpret_cast<char*>(&entry), sizeof(entry))){
+		const TransitionRecord& record = entry.record;
+		if (first){
+			origin = record.timestamp;
+		}
+		const double start = to_us(static_cast<double>(static_cast<std::int64_t>(record.timestamp - origin)));
+		const double exit = to_us(record.exit_ticks);
+		const double action = to_us(record.action_ticks);
+		slice("exit", entry, start, exit);
+		slice("action", entry, start + exit, action);
+		slice("entry", entry, start + exit + action, to_us(record.entry_ticks));
+	}
+	out << "\n]}\n";
+	return true;
+}
+
+} //namespace sm
+} //namespace houdini
@@ -1,6 +1,7 @@
 #pragma once 
 #include <boost/mp11/list.hpp>
 #include "houdini/sm/backend/pseudo_states.hpp"
+#include "houdini/sm/backend/timer_event.hpp"
 
 #include "houdini/util/mp11.hpp"
 
@@ -156,8 +157,13 @@ constexpr auto is_no_guard = [](auto guard){
 	return std::is_same_v<decltype(guard), NoGuard>;
 };
 
+//the guard of a time-triggered transition only counts if one was written in the transition table
 template <class Guard> constexpr decltype(auto) is_guard() {
-	return !std::is_same_v<Guard, NoGuard>;
+	if constexpr (is_timer_guard<Guard>::value){
+		return !std::is_same_v<typename Guard::guard_t, NoGuard>;
+	} else {
+		return !std::is_same_v<Guard, NoGuard>;
+	}
 }
 
 
@@ -0,0 +1,97 @@
+#pragma once
+#include "houdini/util/constants.hpp"
+#include "houdini/util/spsc_ring.hpp"
+#include "houdini/util/tick_clock.hpp"
+#include "houdini/util/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace houdini {
+namespace sm {
+
+/**
+ * @brief Record of a single transition. Times are in `util::read_ticks()` ticks.
+ * `from` and `to` are the indices of the innermost active state before and after the transition.
+ */
+struct TransitionRecord {
+	std::uint64_t timestamp;
+	std::uint32_t exit_ticks;
+	std::uint32_t action_ticks;
+	std::uint32_t entry_ticks;
+	JEvent event;
+	std::uint16_t from;
+	std::uint16_t to;
+	std::uint16_t guards_evaluated;
+};
+
+using TraceRing = util::SpscRing<TransitionRecord, JANUS_TRACE_CAPACITY>;
+
+/**
+ * @brief Records the transitions of one state machine into its trace ring. The state machine is the
+ * producer; a `TraceDrainer` on another thread is the consumer. Records are dropped, and counted,
+ * if the ring is full.
+ */
+class TransitionTracer {
+	public:
+		TraceRing& ring() noexcept {
+			return this->records;
+		}
+
+		std::size_t dropped() const noexcept {
+			return this->dropped_records;
+		}
+
+		void beginEvent() noexcept {
+			this->guards = 0;
+		}
+
+		void guardEvaluated() noexcept {
+			this->guards++;
+		}
+
+		/** @brief Start timing a transition that leaves `from`. */
+		void beginTransition(std::size_t from) noexcept {
+			this->current.timestamp = util::read_ticks();
+			this->current.from = static_cast<std::uint16_t>(from);
+		}
+
+		/** @brief Called after the exited states have been left, before the action. */
+		void exited() noexcept {
+			this->action_start = util::read_ticks();
+			this->current.exit_ticks = narrow(this->action_start - this->current.timestamp);
+		}
+
+		/** @brief Called after the action, before the destination states are entered. */
+		void actionDone() noexcept {
+			this->entry_start = util::read_ticks();
+			this->current.action_ticks = narrow(this->entry_start - this->action_start);
+		}
+
+		void endTransition(JEvent event, std::size_t to) noexcept {
+			this->current.entry_ticks = narrow(util::read_ticks() - this->entry_start);
+			this->current.event = event;
+			this->current.to = static_cast<std::uint16_t>(to);
+			this->current.guards_evaluated = this->guards;
+			if (!this->records.push(this->current)){
+				this->dropped_records++;
+			}
+		}
+
+	private:
+		static std::uint32_t narrow(std::uint64_t ticks) noexcept {
+			constexpr std::uint64_t max = std::numeric_limits<std::uint32_t>::max();
+			return static_cast<std::uint32_t>(ticks < max ? ticks : max);
+		}
+
+		TraceRing records;
+		TransitionRecord current{};
+		std::uint64_t action_start = 0;
+		std::uint64_t entry_start = 0;
+		std::size_t dropped_records = 0;
+		std::uint16_t guards = 0;
+};
+
+} //namespace sm
+} //namespace houdini
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "houdini/sm/backend/event_payload.hpp"
 #include "houdini/util/mp11.hpp"
 #include "houdini/util/types.hpp"
 
+#include <cstddef>
+#include <limits>
 #include <stdexcept>
 #include <queue>
 #include <variant>
@@ -40,12 +43,13 @@ class VariantQueue {
 			return this->queue.size();
 		}
 
-		template <class T> void push(const T& e){
-			this->queue.push(e);
-		}
-
-		template <class T> void push(T&& e){
+		/** @brief Queue an event. Returns false, dropping the event, if the queue is full. */
+		template <class T> bool push(const T& e){
+			if (util::is_full(this->queue)){
+				return false;
+			}
 			this->queue.push(e);
+			return true;
 		}
 
 		template <class Callable>
@@ -68,27 +72,42 @@ class VariantQueue {
  * @brief Wrapper class around std::queue. Used to 
  * restrict the public interface of the queue and facilitate
  * using it for its intended purpose: applying events to callable functions.
+ * Events are queued with a copy of their payload.
  */
 class DeferQueue {
-	using TQueue = std::queue<JEvent>;
-	TQueue queue;
+	using TQueue = JQueue<EventBuffer>;
+	//the queue has no iterators, so `forEach` rotates through it
+	mutable TQueue queue;
 
 	public:
+		DeferQueue() = default;
+		explicit DeferQueue(const JAllocator<EventBuffer>& alloc): queue(alloc) {}
 		
+
 		[[nodiscard]] auto empty() const -> bool {
 			return this->queue.empty();
 		}
 
-		[[nodiscard]] auto size() const -> bool {
+		[[nodiscard]] auto size() const -> std::size_t {
 			return this->queue.size();
 		}
 
-		template <class T> void push(const T& e){
-			this->queue.push(e);
+		/** @brief Largest number of events the queue can hold: `JANUS_STATIC_QUEUE_CAPACITY` with static queues. */
+		static constexpr std::size_t capacity() noexcept {
+#ifdef JANUS_STATIC_QUEUES
+			return TQueue::capacity();
+#else
+			return std::numeric_limits<std::size_t>::max();
+#endif
 		}
 
-		template <class T> void push(T&& e){
+		/** @brief Queue an event. Returns false, dropping the event, if the queue is full. */
+		bool push(const EventBuffer& e){
+			if (util::is_full(this->queue)){
+				return false;
+			}
 			this->queue.push(e);
+			return true;
 		}
 
 		template <class Callable>
@@ -101,6 +120,23 @@ class DeferQueue {
 			this->queue.pop();
 			callable(front_element);
 		}
+
+		/** @brief Call `callable` on each queued event, in order, leaving the queue unchanged. */
+		template <class Callable>
+		void forEach(const Callable& callable) const {
+			for (std::size_t i = this->queue.size(); i > 0; i--){
+				EventBuffer event = this->queue.front();
+				this->queue.pop();
+				callable(event);
+				this->queue.push(event);
+			}
+		}
+
+		void clear(){
+			while (!this->queue.empty()){
+				this->queue.pop();
+			}
+		}
 };
 
 } //namespace sm
@@ -3,6 +3,7 @@
 #include "houdini/actor/context.hpp"
 #include "houdini/brokers/message_broker.hpp"
 #include "houdini/util/constants.hpp"
+#include "houdini/util/types.hpp"
 
 #include <cstddef>
 #include <memory>
@@ -14,6 +15,15 @@ namespace houdini {
 namespace sm {
 
 
+struct StateAccess;
+
+/**
+ * @brief Base class of all states. Override `onEntry`, `onExit` and `update` to give the state 
+ * behavior, and declare a public `Behaviors<...> behaviors` member to attach behaviors. 
+ * 
+ * @par The state machine determines at compile time which of these each state type provides, 
+ * and does not call anything for states that provide none of them.
+ */
 template <typename Context = act::BaseContext, typename Broker = brokers::BaseBroker>
 struct State {
     State() = default;
@@ -21,50 +31,37 @@ struct State {
 
     virtual ~State() {}
 
+    /** @brief Call the entry hook of the state. Behaviors are called by the state machine. */
     void onEntryImpl(Context& context, Broker& broker){
         this->onEntry(context, broker);
-        for (auto& behavior:this->behaviors){
-            if (behavior)
-                behavior->onEntryImpl(context, broker);
-            else break;
-        }
     }
 
+    /** @brief Call the exit hook of the state. Behaviors are called by the state machine. */
     void onExitImpl(Context& context, Broker& broker){
         this->onExit(context, broker);
-        for (auto& behavior:this->behaviors){
-            if (behavior)
-                behavior->onExitImpl(context, broker);
-            else break;
-        }
     }
 
     void updateImpl(Context& context, Broker& broker){
-        if (this->update_frequency > std::chrono::milliseconds::zero() && std::chrono::steady_clock::now() - this->last_update >= this->update_frequency){
-            this->last_update = std::chrono::steady_clock::now();
+        this->updateImpl(context, broker, SteadyClock::now());
+    }
+
+    /**
+     * @brief Call the update hook of the state if it is due as of time `now`, which need not come from the system clock. 
+     */
+    void updateImpl(Context& context, Broker& broker, TimePoint now){
+        if (this->update_frequency > std::chrono::milliseconds::zero() && now - this->last_update >= this->update_frequency){
+            this->last_update = now;
             this->update(context, broker);
         }
-        for (auto& behavior:this->behaviors){
-            if (behavior)
-                behavior->updateImpl(context, broker);
-            else break;
-        }
     }
 
     protected:
-	template <typename... Behaviors>
-	auto addBehaviors(Behaviors... behaviors_){
-        static_assert(sizeof...(Behaviors) <= JANUS_MAX_BEHAVIORS, "Cannot supply more behaviors than maximum.");
-        //utility function to create behaviors in the array
-        this->behaviors = {std::unique_ptr<Behavior<Context,Broker>>(new Behaviors(std::move(behaviors_))...)};
-		
-	}
-    std::array<std::unique_ptr<Behavior<Context,Broker>>, JANUS_MAX_BEHAVIORS> behaviors; 
-    //this could be a vector but for some reason unique_ptrs won't get constructed properly when passed in via a parameter pack
-
-    std::chrono::time_point<std::chrono::steady_clock> last_update;
+    TimePoint last_update;
 
     private:
+    //lets the state machine detect at compile time which hooks are overridden
+    friend struct StateAccess;
+
 	virtual void onEntry(Context&, Broker&){}
 	virtual void onExit(Context&, Broker&){}
     virtual void update(Context&, Broker&){}
@@ -1,9 +1,14 @@
 #pragma once
 #include "houdini/actor/context.hpp"
 #include "houdini/brokers/message_broker.hpp"
+#include "houdini/util/types.hpp"
 
 #include <chrono>
+#include <cstddef>
 #include <locale>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace houdini {
 namespace sm {
@@ -16,13 +21,13 @@ class BaseBehavior {
 	
 		virtual void onEntryImpl(act::BaseContext& context, brokers::BaseBroker& broker) = 0;
 		virtual void onExitImpl(act::BaseContext& context, brokers::BaseBroker& broker) = 0;
-		virtual void updateImpl(act::BaseContext& context, brokers::BaseBroker& broker) = 0;
+		virtual void updateImpl(act::BaseContext& context, brokers::BaseBroker& broker, TimePoint now) = 0;
 		virtual ~BaseBehavior(){}
 		std::chrono::milliseconds update_frequency{200};
 
 	protected:
 
-		std::chrono::time_point<std::chrono::steady_clock> last_update;
+		TimePoint last_update;
 };
 
 /**
@@ -48,8 +53,9 @@ class Behavior : public BaseBehavior {
 			onExit(static_cast<Context&>(context), static_cast<Broker&>(broker));
 		}
 
-		void updateImpl(act::BaseContext& context, brokers::BaseBroker& broker) override final {
-			if (this->update_frequency > std::chrono::milliseconds::zero() && std::chrono::steady_clock::now() - this->last_update >= this->update_frequency){
+		void updateImpl(act::BaseContext& context, brokers::BaseBroker& broker, TimePoint now) override final {
+			if (this->update_frequency > std::chrono::milliseconds::zero() && now - this->last_update >= this->update_frequency){
+				this->last_update = now;
 				update(static_cast<Context&>(context), static_cast<Broker&>(broker));
 			}
 		}
@@ -58,5 +64,46 @@ class Behavior : public BaseBehavior {
 		virtual void onExit(Context&, Broker&){}
 		virtual void update(Context&, Broker&){}
 };
+
+/**
+ * \brief Compile-time list of the behaviors of a state, stored in place. To add behaviors to a state, 
+	declare a public data member named `behaviors` of this type:
+	`houdini::Behaviors<Logging, Heartbeat> behaviors{Logging{}, Heartbeat{500}};`
+	The state machine detects it at compile time, and calls the behaviors directly. States without
+	behaviors carry no storage or overhead for them. 
+*/
+template <typename... Bs>
+class Behaviors {
+	static_assert(sizeof...(Bs) <= JANUS_MAX_BEHAVIORS, "Cannot supply more behaviors than maximum.");
+	static_assert((std::is_base_of_v<BaseBehavior, Bs> && ...), "Behaviors must be derived from houdini::Behavior.");
+
+	public:
+		Behaviors() = default;
+		explicit Behaviors(Bs... behaviors_) : members(std::move(behaviors_)...) {}
+
+		template <typename Func>
+		void forEach(Func&& func){
+			std::apply([&func](auto&... behavior){ (func(behavior), ...); }, this->members);
+		}
+
+		template <std::size_t I>
+		auto& get(){
+			return std::get<I>(this->members);
+		}
+
+		static constexpr std::size_t size(){
+			return sizeof...(Bs);
+		}
+
+	private:
+		std::tuple<Bs...> members;
+};
+
+template <typename T>
+struct is_behaviors : std::false_type {};
+
+template <typename... Bs>
+struct is_behaviors<Behaviors<Bs...>> : std::true_type {};
+
+}
 }
-}
\ No newline at end of file
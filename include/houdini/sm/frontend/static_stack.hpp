@@ -1,10 +1,13 @@
 #pragma once
 
 #include <array>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
-#include <iostream>
 #include <initializer_list>
+#include <limits>
+#include <type_traits>
 #include <utility>
 
 namespace houdini {
@@ -13,8 +16,8 @@ namespace sm {
 /** \brief A simple wrapper around std::array to emulate 
  * a stack with no dynamic memory allocation.
  * 
- * \todo move constructor current invalidates the end_ptr. 
- * The reason why is unclear - need to investigate. 
+ * The number of elements is kept as a small integer rather than an iterator, 
+ * so for trivially copyable `T` the stack is itself trivially copyable and can be copied with memcpy.
  */
 template <typename T, std::size_t N>
 class StaticStack {
@@ -27,12 +30,11 @@ class StaticStack {
 	using const_iterator = typename StackType::const_iterator;
 	using reverse_iterator = typename StackType::reverse_iterator;
 	using const_reverse_iterator = typename StackType::const_reverse_iterator;
+	//smallest unsigned type that can hold the number of elements
+	using count_type = std::conditional_t<(N <= std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+		std::conditional_t<(N <= std::numeric_limits<std::uint16_t>::max()), std::uint16_t, size_type>>;
 
-	constexpr StaticStack(){}
-
-	constexpr StaticStack(const StaticStack& other): stack(other.stack) {
-		this->end_ptr = this->stack.begin() + other.size();
-	}
+	constexpr StaticStack() = default;
 
 	constexpr StaticStack(const_iterator begin, const_iterator end){
 		while(begin != end){
@@ -40,25 +42,6 @@ class StaticStack {
 			begin++;
 		}
 	}
-
-	constexpr StaticStack(StaticStack&& other) noexcept {
-		//TODO: moving the stack can lead to the end_ptr being invalidated. 
-		//the reason is unclear. 
-		for (auto iter = other.begin(); iter != other.end(); iter++){
-			*(this->end_ptr) = std::move(*iter);
-			this->end_ptr++;
-		}
-	}
-
-	constexpr StaticStack operator=(const StaticStack& other){
-		return StaticStack(other);
-	}
-
-	constexpr StaticStack operator=(StaticStack&& other) noexcept {
-		return StaticStack(std::move(other));
-	}
-
-	~StaticStack(){}
 	
 	template <std::size_t V>
 	constexpr StaticStack(const std::array<T, V>& array){
@@ -74,42 +57,33 @@ class StaticStack {
 	}
 
 	constexpr StaticStack(std::initializer_list<T> list){
-		static_assert(list.size() <= N, "Number of elements in initializer list exceeds maximum size of stack.");
-		for (T&& item:list){
+		assert(list.size() <= N && "Number of elements in initializer list exceeds maximum size of stack.");
+		for (const T& item:list){
 			this->push_back(item);
 		}
 	}
 
-	// constexpr void push_back(T item) {
-	// 	assert(this->end_ptr != this->stack.end() && "Stack overflow");
-	// 	*(this->end_ptr) = item;
-	// 	this->end_ptr++;
-	// }
-
 	constexpr void push_back(T&& item) noexcept {
-		assert(this->end_ptr != this->stack.end() && "Stack overflow");
-		assert(this->size() <= difference_type(this->stack.max_size()) && "Stack overflow");
-		*(this->end_ptr) = std::forward<T>(item);
-		this->end_ptr++;
+		assert(this->count < N && "Stack overflow");
+		this->stack[this->count] = std::forward<T>(item);
+		++this->count;
 	}
 
 	constexpr void push_back(const T& item) {
-		assert(this->end_ptr != this->stack.end() && "Stack overflow");
-		assert(this->size() <= difference_type(this->stack.max_size()) && "Stack overflow");
-		*(this->end_ptr) = item;
-		this->end_ptr++;
+		assert(this->count < N && "Stack overflow");
+		this->stack[this->count] = item;
+		++this->count;
 	}
 	
 	/** @brief Push to front of stack. O(n) operation.
 	*/
 	constexpr void push_front(T&& item) noexcept {
-		assert(this->end_ptr != this->stack.end() && "Stack overflow");
-		for (size_type i = size_type(this->size()); i > 0; i--){
+		assert(this->count < N && "Stack overflow");
+		for (size_type i = this->count; i > 0; i--){
 			this->stack[i] = this->stack[i-1];
 		}
 		this->stack[0] = std::forward<T>(item);
-		this->end_ptr++;
-		assert(this->size() <= difference_type(this->stack.max_size()) && "Stack overflow");
+		++this->count;
 	}
 
 	template <typename Type>
@@ -123,8 +97,8 @@ class StaticStack {
 	}
 
 	constexpr void pop(){
-		assert(this->size() > 0 && "Stack underflow"); 
-		this->end_ptr--;
+		assert(this->count > 0 && "Stack underflow"); 
+		--this->count;
 	}
 
 	[[nodiscard]] constexpr T& front() {
@@ -136,37 +110,43 @@ class StaticStack {
 	}
 
 	[[nodiscard]] constexpr T& back() {
-		return *(this->end_ptr-1);
+		return this->stack[this->count - 1];
 	}
 
 	[[nodiscard]] constexpr const T& back() const {
-		return *(this->end_ptr-1);
+		return this->stack[this->count - 1];
 	}
 
 	constexpr void clear() {
-		this->end_ptr = this->stack.begin();
+		this->count = 0;
 	}
 
 	constexpr bool empty() const {
-		return this->end_ptr == this->cbegin();
+		return this->count == 0;
 	}
 
-	difference_type size() const noexcept {
-		difference_type n = std::distance(this->cbegin(), this->cend());
-		assert(n >= 0 && "Size of stack is invalid");
-		return n;
+	constexpr difference_type size() const noexcept {
+		return difference_type(this->count);
 	}
 
 	constexpr size_type max_size() const noexcept {
-		return this->stack.max_size();
+		return N;
 	}
 
-	iterator begin(){
+	constexpr iterator begin(){
 		return this->stack.begin();
 	}
 	
-	iterator end(){
-		return this->end_ptr;
+	constexpr iterator end(){
+		return this->stack.begin() + this->count;
+	}
+
+	constexpr const_iterator begin() const {
+		return this->cbegin();
+	}
+	
+	constexpr const_iterator end() const {
+		return this->cend();
 	}
 
 	constexpr const_iterator cbegin() const {
@@ -174,30 +154,29 @@ class StaticStack {
 	}
 
 	constexpr const_iterator cend() const {
-		return const_iterator(this->end_ptr);
+		return this->stack.cbegin() + this->count;
 	}
 
-	reverse_iterator rbegin() {
-		return std::make_reverse_iterator(this->end_ptr);
+	constexpr reverse_iterator rbegin() {
+		return std::make_reverse_iterator(this->end());
 	}
 
-	reverse_iterator rend(){
+	constexpr reverse_iterator rend(){
 		return std::make_reverse_iterator(this->begin());
 	}
 
 	constexpr const_reverse_iterator crbegin() const {
-		return std::make_reverse_iterator(const_iterator(this->end_ptr));
+		return std::make_reverse_iterator(this->cend());
 	}
 
 	constexpr const_reverse_iterator crend() const {
 		return std::make_reverse_iterator(this->cbegin());
 	}
 
-		StackType stack;
+		StackType stack{};
 	private:
-
-		iterator end_ptr = stack.begin();
+		count_type count = 0;
 };
 
 }
-}
\ No newline at end of file
+}
@@ -158,7 +158,7 @@ template <class Source, class Guard> class TransitionSG {
 		 {}
 		
 		template <class Target> constexpr auto operator=(const Target&){
-			return detail::makeTransition<TState<Source>, PLACEHOLDER_NO_EVENT_VALUE, NoAction, Guard, Target>{};
+			return detail::makeTransition<TState<Source>, PLACEHOLDER_NO_EVENT_VALUE, Guard, NoAction, Target>{};
 		}
 	
 	private:
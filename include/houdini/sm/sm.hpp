@@ -2,6 +2,8 @@
 #include "houdini/sm/backend/state_machine.hpp"
 #include "houdini/sm/backend/state.hpp"
 #include "houdini/sm/backend/event.hpp"
+#include "houdini/sm/backend/timer_event.hpp"
+#include "houdini/sm/backend/event_payload.hpp"
 #include "houdini/sm/backend/transition_table.hpp"
 #include "houdini/sm/frontend/behavior.hpp"
 #include "houdini/sm/frontend/transition_dsl.hpp"
@@ -17,7 +19,12 @@ using sm::history;
 using sm::SM;
 using sm::State;
 using sm::Behavior;
+using sm::Behaviors;
 using sm::SMResult;
 using sm::transition_table;
 using sm::events;
+using sm::after;
+using sm::every;
+using sm::EventBuffer;
+using sm::InternalEventQueue;
 } //namespace houdini
\ No newline at end of file
@@ -14,4 +14,33 @@
 
 #ifndef JANUS_ENUM_MAX
 #define JANUS_ENUM_MAX 257
-#endif
\ No newline at end of file
+#endif
+
+//number of enum values reflected by each template instantiation when scanning the values of an enum
+#ifndef JANUS_ENUM_CHUNK
+#define JANUS_ENUM_CHUNK 64
+#endif
+
+//capacity of event queues when JANUS_STATIC_QUEUES is defined
+#ifndef JANUS_STATIC_QUEUE_CAPACITY
+#define JANUS_STATIC_QUEUE_CAPACITY 64
+#endif
+//largest event payload that can be stored in place in an EventBuffer
+#ifndef JANUS_MAX_EVENT_PAYLOAD_SIZE
+#define JANUS_MAX_EVENT_PAYLOAD_SIZE 64
+#endif
+
+//maximum number of events a state machine's actions can post to it while processing a single event
+#ifndef JANUS_INTERNAL_EVENT_QUEUE_CAPACITY
+#define JANUS_INTERNAL_EVENT_QUEUE_CAPACITY 16
+#endif
+
+//number of transition records each state machine can buffer when JANUS_TRACING is defined. Must be a power of two.
+#ifndef JANUS_TRACE_CAPACITY
+#define JANUS_TRACE_CAPACITY 1024
+#endif
+
+//hardware performance counters are aggregated into the latency metrics, so they enable them
+#if defined(JANUS_PERF_COUNTERS) && !defined(JANUS_METRICS)
+#define JANUS_METRICS
+#endif
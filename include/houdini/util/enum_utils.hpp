@@ -26,6 +26,20 @@ namespace houdini {
 
 namespace util {
 
+/**
+ * @brief Range of values scanned to reflect the enum `E`, [JANUS_ENUM_MIN, JANUS_ENUM_MAX] by default. 
+ * Specialize it with `min` and `max` members to scan another range, for instance for enums with more than 
+ * 257 values. An enum whose values are known to be `min` (0 by default) to `min + count - 1`, with no gaps,
+ * can instead declare a `count` member, in which case its values are not scanned at all:
+ * 
+ * @code
+ * template <> struct houdini::util::enum_range<MyEvents> {
+ *     static constexpr std::size_t count = 16;
+ * };
+ * @endcode
+ */
+template <typename E, typename = void>
+struct enum_range {};
 
 namespace _enum {
 
@@ -105,6 +119,110 @@ constexpr bool is_valid() noexcept {
     return n<E, static_cast<E>(V)>().size() != 0;
 }
 
+template <typename E, typename = void>
+struct has_range_min : std::false_type {};
+
+template <typename E>
+struct has_range_min<E, std::void_t<decltype(enum_range<E>::min)>> : std::true_type {};
+
+template <typename E, typename = void>
+struct has_range_max : std::false_type {};
+
+template <typename E>
+struct has_range_max<E, std::void_t<decltype(enum_range<E>::max)>> : std::true_type {};
+
+template <typename E, typename = void>
+struct has_declared_count : std::false_type {};
+
+template <typename E>
+struct has_declared_count<E, std::void_t<decltype(enum_range<E>::count)>> : std::true_type {};
+
+/** @brief Whether the values of E are declared through `enum_range<E>::count` rather than scanned. */
+template <typename E, bool IsFlags>
+inline constexpr bool is_declared_v = !IsFlags && has_declared_count<E>::value;
+
+constexpr int to_int(long long value) noexcept {
+    return static_cast<int>(value);
+}
+
+template <typename E>
+constexpr int range_min() noexcept {
+    if constexpr (has_range_min<E>::value){
+        return to_int(enum_range<E>::min);
+    } else if constexpr (has_declared_count<E>::value){
+        return 0;
+    } else {
+        return JANUS_ENUM_MIN;
+    }
+}
+
+template <typename E>
+constexpr int range_max() noexcept {
+    if constexpr (has_declared_count<E>::value){
+        static_assert(enum_range<E>::count > 0, "enum_range count must be positive.");
+        return range_min<E>() + to_int(enum_range<E>::count) - 1;
+    } else if constexpr (has_range_max<E>::value){
+        return to_int(enum_range<E>::max);
+    } else {
+        return JANUS_ENUM_MAX;
+    }
+}
+
+/**
+ * @brief Names of the N values of the pack `V` in the `__PRETTY_FUNCTION__` string of `pack_names`,
+ * "... [with E = EnumType; E ...V = {a, b, (EnumType)2}]" for gcc and "... [E = EnumType, V = <a, b, (EnumType)2>]" for clang.
+ * As in `pretty_name`, the name of each value is the identifier it ends with, and values printed as a cast 
+ * end with a number instead. Commas nested in brackets, as in the names of class template members, do not separate values.
+ */
+template <std::size_t N, std::size_t L>
+constexpr std::array<string_view, N> parse_pack_names(const char (&pretty)[L]) noexcept {
+    std::array<string_view, N> names{};
+    std::size_t i = string_view{pretty, L - 1}.find("V = ");
+    if (i == string_view::npos){
+        return names;
+    }
+    //the list is found from the front, as it makes up most of the string, and its characters are 
+    //tested inline, as function calls are slow in constant evaluation. Skip its opening bracket.
+    i += 5;
+    std::size_t depth = 0;
+    std::size_t count = 0;
+    std::size_t name_start = i;
+    for (; i < L - 1 && count < N; ++i){
+        const char c = pretty[i];
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'){
+            continue;
+        }
+        const bool closing = c == ')' || c == '>' || c == '}' || c == ']';
+        if (c == '(' || c == '<' || c == '{' || c == '['){
+            ++depth;
+        } else if (depth > 0 && closing){
+            --depth;
+        } else if (depth == 0 && (c == ',' || closing)){
+            //a comma, or the closing bracket of the list
+            if (i > name_start && !(pretty[name_start] >= '0' && pretty[name_start] <= '9')){
+                names[count] = string_view{pretty + name_start, i - name_start};
+            }
+            ++count;
+        }
+        name_start = i + 1;
+    }
+    return names;
+}
+
+/**
+ * @brief Names of the values `V` of the enum `E`, empty for values without an enumerator. All the values 
+ * are reflected by a single instantiation, rather than one per value as `n` does, which is much faster to compile.
+ */
+template <typename E, E... V>
+constexpr auto pack_names() noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+    constexpr auto names = parse_pack_names<sizeof...(V)>(__PRETTY_FUNCTION__);
+#else
+    #error "Unsupported compiler. Must use Clang 5.0+ or gcc 9.0+."
+#endif
+    return names;
+}
+
 /**
  @brief returns an enum value i + a constexpr offset O. 
  Typically Used to test the range of validity of an enum type.
@@ -173,13 +291,16 @@ constexpr int reflected_min() noexcept {
     if constexpr (IsFlags){
         return 0;
     } else {
-        constexpr U lhs = JANUS_ENUM_MIN;
+        constexpr U lhs = range_min<E>();
         static_assert(std::numeric_limits<std::int16_t>::min(), "Enum minimum must be greater than int16 min");
 
         constexpr auto rhs = std::numeric_limits<U>::min();
 
         if constexpr (cmp_less(rhs,lhs)){
-            static_assert(!is_valid<E, value<E, lhs-1, IsFlags>(0)>(), "Enum value smaller than min range size detected.");
+            //declared values are trusted, and not reflected at all
+            if constexpr (!is_declared_v<E, IsFlags>){
+                static_assert(!is_valid<E, value<E, lhs-1, IsFlags>(0)>(), "Enum value smaller than min range size detected.");
+            }
             return lhs;
         } else {
             return rhs;
@@ -199,12 +320,14 @@ constexpr int reflected_max() noexcept {
     if constexpr (IsFlags){
         return std::numeric_limits<U>::digits-1;
     } else {
-        constexpr U lhs = JANUS_ENUM_MAX; //shouldn't exceed user specified maximum
+        constexpr U lhs = range_max<E>(); //shouldn't exceed user specified maximum
         static_assert(lhs < std::numeric_limits<std::int16_t>::max(), "Enum max must be smaller than int16 max");
         constexpr auto rhs = std::numeric_limits<U>::max();
 
         if constexpr (cmp_less(lhs, rhs)){
-            static_assert(!is_valid<E, value<E, lhs + 1, IsFlags>(0)>(), "Enum value larger than max range size detected.");
+            if constexpr (!is_declared_v<E, IsFlags>){
+                static_assert(!is_valid<E, value<E, lhs + 1, IsFlags>(0)>(), "Enum value larger than max range size detected.");
+            }
             return lhs;
         } else {
             return rhs;
@@ -226,13 +349,13 @@ constexpr std::array<std::remove_cv_t<T>, N> to_array(T (&a)[N], std::index_sequ
 }
 
 /**
- @brief Get number of true values in a C-style bool array
+ @brief Get number of values with a name in an array of names
 */
 template <std::size_t N>
-constexpr std::size_t values_count(const bool (&valid)[N]) noexcept {
+constexpr std::size_t values_count(const std::array<string_view, N>& names) noexcept {
     auto count = std::size_t{0};
     for (std::size_t i = 0; i < N; ++i){
-        if (valid[i]){
+        if (!names[i].empty()){
             ++count;
         }
     }
@@ -240,51 +363,76 @@ constexpr std::size_t values_count(const bool (&valid)[N]) noexcept {
     return count;
 }
 
-/**
- @brief Create an array of containing the possible values of the enum E.
+template <typename E, int Min, bool IsFlags, std::size_t Offset, std::size_t... I>
+constexpr auto scan_chunk(std::index_sequence<I...>) noexcept {
+    return pack_names<E, value<E, Min, IsFlags>(Offset + I)...>();
+}
 
- @example enum {FIRST = 0, SECOND = 1, THIRD = 10} -> [0,1,10]
+template <std::size_t N, std::size_t M>
+constexpr void copy_names(std::array<string_view, N>& names, std::size_t offset, const std::array<string_view, M>& chunk) noexcept {
+    for (std::size_t i = 0; i < M; ++i){
+        names[offset + i] = chunk[i];
+    }
+}
+
+/**
+ @brief Get the names of the values i + Min of the enum E, for i from 0 to Size - 1, or an empty name if the value
+ has no enumerator. Values are reflected JANUS_ENUM_CHUNK at a time. 
 */
-template <typename E, bool IsFlags, int Min, std::size_t... I>
-constexpr auto values(std::index_sequence<I...>) noexcept {
-    //index sequence contains all possible values that the enum can cover
-    //e.g. [0,1,2,3,4,5,6,7,8,9,10]
-    //determine if value I maps to a valid enum value
-    constexpr bool valid[sizeof...(I)] = {is_valid<E, value<E, Min, IsFlags>(I)>()...}; 
-    constexpr std::size_t count = values_count(valid);
-
-    //once we know which values are valid, we group them into a compacted array 
-    //so we can easily iterate over it
-    if constexpr (count > 0){
-        E values[count] = {};
-        for (std::size_t i = 0, v=0; v< count; ++i){
-            if (valid[i]){
-                values[v++] = value<E,Min,IsFlags>(i);
-            }
-        }
-        return to_array(values, std::make_index_sequence<count>{});
+template <typename E, int Min, bool IsFlags, std::size_t Size, std::size_t... K>
+constexpr auto scan_chunks(std::index_sequence<K...>) noexcept {
+    std::array<string_view, Size> names{};
+    (copy_names(names, K * JANUS_ENUM_CHUNK, scan_chunk<E, Min, IsFlags, K * JANUS_ENUM_CHUNK>(
+        std::make_index_sequence<(std::min)(std::size_t{JANUS_ENUM_CHUNK}, Size - K * JANUS_ENUM_CHUNK)>{})), ...);
+    return names;
+}
 
-    } else {
-        //no valid values :(
-        return std::array<E, 0>{}; 
-    }
+/**
+ @brief Get the names of all the values in the reflected range of the enum E. 
 
+ @example enum {FIRST = 0, SECOND = 1, THIRD = 3} -> ["FIRST", "SECOND", "", "THIRD", "", ...]
+*/
+template <typename E, bool IsFlags>
+constexpr auto scan() noexcept {
+    constexpr auto min = reflected_min<E, IsFlags>();
+    constexpr auto max = reflected_max<E, IsFlags>();
+    constexpr auto range_size = static_cast<std::size_t>(max - min + 1);
+    constexpr std::size_t chunks = (range_size + JANUS_ENUM_CHUNK - 1) / JANUS_ENUM_CHUNK;
+
+    return scan_chunks<E, min, IsFlags, range_size>(std::make_index_sequence<chunks>{});
 }
 
+/** @brief Names of the values in the reflected range of enum E, scanned once per enum. */
+template <typename E, bool IsFlags = false>
+inline constexpr auto scanned_names_v = scan<E, IsFlags>();
+
 /**
- @brief Create an array of containing the valid values of the enum E.
+ @brief Create an array of containing the valid values of the enum E. Values declared through `enum_range` 
+ are not scanned.
 
  @example enum {FIRST = 0, SECOND = 1, THIRD = 10} -> [0,1,10]
 */
 template <typename E, bool IsFlags, typename U = std::underlying_type_t<E>>
 constexpr auto values() noexcept {
-    //start by determining all possible values that the enum can cover
     constexpr auto min = reflected_min<E, IsFlags>();
-    constexpr auto max = reflected_max<E, IsFlags>();
-    constexpr auto range_size = max - min +1;
-    
-    //once full range is determined, find which values map to valid enum values and return array of those
-    return values<E, IsFlags, reflected_min_v<E, IsFlags>>(std::make_index_sequence<range_size>{});
+    if constexpr (is_declared_v<E, IsFlags>){
+        std::array<E, enum_range<E>::count> values{};
+        for (std::size_t i = 0; i < values.size(); ++i){
+            values[i] = value<E, min, IsFlags>(i);
+        }
+        return values;
+    } else {
+        //once we know which values are valid, we group them into a compacted array 
+        //so we can easily iterate over it
+        constexpr auto& names = scanned_names_v<E, IsFlags>;
+        std::array<E, values_count(names)> values{};
+        for (std::size_t i = 0, v = 0; v < values.size(); ++i){
+            if (!names[i].empty()){
+                values[v++] = value<E, min, IsFlags>(i);
+            }
+        }
+        return values;
+    }
 }
 
 template <typename E, bool IsFlags = false>
@@ -312,17 +460,26 @@ template <typename E, E V>
 inline constexpr auto enum_name_v = n<E,V>();
 
 /**
- @brief Create an array of string views representing the enum names.
+ @brief Create an array of string views representing the enum names, in the order of `values_v`.
 */
-template <typename E, bool IsFlags, std::size_t... I>
-constexpr auto names(std::index_sequence<I...>) noexcept {
-    //given an array of valid enum values, 
-    //we need to iterate over the array and translate each value to its name
-    return std::array<string_view, sizeof...(I)>{{enum_name_v<E, values_v<E, IsFlags>[I]>...}};
+template <typename E, bool IsFlags>
+constexpr auto names() noexcept {
+    //given the names of all the scanned values, keep those of the valid values
+    constexpr auto& scanned = scanned_names_v<E, IsFlags>;
+    if constexpr (is_declared_v<E, IsFlags>){
+        static_assert(values_count(scanned) == scanned.size(), "Enums declaring a count in enum_range must have a name for every value.");
+    }
+    std::array<string_view, count_v<E, IsFlags>> names{};
+    for (std::size_t i = 0, v = 0; v < names.size(); ++i){
+        if (is_declared_v<E, IsFlags> || !scanned[i].empty()){
+            names[v++] = scanned[i];
+        }
+    }
+    return names;
 }
 
 template <typename E, bool IsFlags = false>
-inline constexpr auto names_v = names<E, IsFlags>(std::make_index_sequence<count_v<E, IsFlags>>{});
+inline constexpr auto names_v = names<E, IsFlags>();
 
 template <typename E, bool IsFlags =false, typename D = std::decay_t<E>>
 using names_t = decltype((names_v<D, IsFlags>));
@@ -363,19 +520,25 @@ inline constexpr auto invalid_index_v = (std::numeric_limits<index_t<E, IsFlags>
 template <typename E, bool IsFlags = false>
 inline constexpr bool is_sparse_v = is_sparse<E, IsFlags>();
 
-template <typename E, bool IsFlags, std::size_t... I>
-constexpr auto indexes(std::index_sequence<I...>) noexcept {
+template <typename E, bool IsFlags, typename U = std::underlying_type_t<E>>
+constexpr auto indexes() noexcept {
   static_assert(std::is_enum_v<E>, "_enum::indexes requires enum type.");
   //if enum E skips values then the values in its values_v array cannot be determined by a simple offset.
   //therefore, must create a data structure that reverse maps values to their corresponding indices
   constexpr auto min = IsFlags ? log2(min_v<E, IsFlags>) : min_v<E, IsFlags>;
-  [[maybe_unused]] auto i = index_t<E, IsFlags>{0};
-
-  return std::array<decltype(i), sizeof...(I)>{{(is_valid<E, value<E, min, IsFlags>(I)>() ? i++ : invalid_index_v<E, IsFlags>)...}};
+  std::array<index_t<E, IsFlags>, range_size_v<E, IsFlags>> indexes{};
+  for (auto& index:indexes){
+    index = invalid_index_v<E, IsFlags>;
+  }
+  for (std::size_t i = 0; i < count_v<E, IsFlags>; ++i){
+    const auto v = static_cast<U>(values_v<E, IsFlags>[i]);
+    indexes[static_cast<std::size_t>((IsFlags ? log2(v) : v) - min)] = static_cast<index_t<E, IsFlags>>(i);
+  }
+  return indexes;
 }
 
 template <typename E, bool IsFlags = false>
-inline constexpr auto indexes_v = indexes<E, IsFlags>(std::make_index_sequence<range_size_v<E, IsFlags>>{});
+inline constexpr auto indexes_v = indexes<E, IsFlags>();
 
 /** 
  @brief Get the index an enum value in its corresponding value_v array.
@@ -406,11 +569,167 @@ constexpr std::size_t endex(E value) noexcept {
     return undex<E>(static_cast<U>(value));
 }
 
+/**
+ @brief Names of the values of the enum E indexed by their offset from `min_v`, empty for values without an enumerator.
+ An extra empty name at the end stands for all values out of range, so that names can be looked up without branching.
+*/
+template <typename E, typename U = std::underlying_type_t<E>>
+constexpr auto value_names() noexcept {
+    std::array<string_view, range_size_v<E> + 1> names{};
+    for (std::size_t i = 0; i < count_v<E>; ++i){
+        names[static_cast<std::size_t>(static_cast<U>(values_v<E>[i]) - min_v<E>)] = names_v<E>[i];
+    }
+    return names;
+}
+
+template <typename E>
+inline constexpr auto value_names_v = value_names<E>();
+
+/** @brief Final mix of MurmurHash3, so that every bit of the result depends on every bit of `hash`. */
+constexpr std::uint64_t mix_hash(std::uint64_t hash) noexcept {
+    hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdu;
+    hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53u;
+    return hash ^ (hash >> 33);
+}
+
+constexpr std::uint64_t name_byte(const char* chars, std::size_t j) noexcept {
+    return std::uint64_t{static_cast<unsigned char>(chars[j])} << (8 * j);
+}
+
+/** 
+ @brief Hash of an enum name, 8 characters at a time. The characters are read one by one so that it can also be
+ computed at compile time, and whole words are spelled out so that compilers merge them into a single load.
+*/
+constexpr std::uint64_t name_hash(string_view name) noexcept {
+    const auto word = [](const char* chars){
+        return name_byte(chars, 0) | name_byte(chars, 1) | name_byte(chars, 2) | name_byte(chars, 3)
+            | name_byte(chars, 4) | name_byte(chars, 5) | name_byte(chars, 6) | name_byte(chars, 7);
+    };
+    const std::size_t size = name.size();
+    std::uint64_t hash = size * 0x9e3779b97f4a7c15u;
+    if (size < 8){
+        std::uint64_t last = 0;
+        for (std::size_t j = 0; j < size; ++j){
+            last |= name_byte(name.data(), j);
+        }
+        return mix_hash(hash ^ last);
+    }
+    for (std::size_t i = 0; i + 8 < size; i += 8){
+        hash = (hash ^ word(name.data() + i)) * 0x9e3779b97f4a7c15u;
+        hash ^= hash >> 29;
+    }
+    //the last 8 characters, which can overlap with the previous word
+    return mix_hash(hash ^ word(name.data() + size - 8));
+}
+
+/** @brief Map the high bits of a hash to [0, n) with a multiplication rather than a division. */
+constexpr std::size_t reduce_hash(std::uint64_t hash, std::size_t n) noexcept {
+    return static_cast<std::uint32_t>(((hash >> 32) * n) >> 32);
+}
+
+/**
+ @brief Minimal perfect hash of the N names of an enum, built with the hash and displace method: names are first 
+ split into N buckets by their hash. Then, from the largest bucket to the smallest, the names of each bucket are 
+ placed in the N slots with the first seed for which their hash, mixed with the seed, lands them all in free slots.
+ Looking up a name therefore takes a single hash of the name, a mix of the hash and a single string comparison.
+*/
+template <std::size_t N>
+struct NameHashTable {
+    //seed of the names of each bucket
+    std::array<std::uint32_t, N> seeds{};
+    //index in `names_v` of the name in each slot
+    std::array<std::uint16_t, N> slots{};
+
+    static constexpr std::size_t slot(std::uint64_t hash, std::uint32_t seed) noexcept {
+        return reduce_hash(mix_hash(hash ^ (seed * 0x9e3779b97f4a7c15u)), N);
+    }
+
+    constexpr std::size_t slot(string_view name) const noexcept {
+        const std::uint64_t hash = name_hash(name);
+        return slot(hash, this->seeds[reduce_hash(hash, N)]);
+    }
+};
+
+template <std::size_t N>
+constexpr NameHashTable<N> make_name_hash_table(const std::array<string_view, N>& names) noexcept {
+    NameHashTable<N> table{};
+    //the names of each bucket are kept together in `members`, from `starts[bucket]` to `starts[bucket + 1]`
+    std::array<std::uint64_t, N> hashes{};
+    std::array<std::size_t, N> buckets{};
+    std::array<std::size_t, N + 1> starts{};
+    //values without a name are left out, as their identical names would collide under every seed
+    std::size_t named = N;
+    for (std::size_t i = 0; i < N; ++i){
+        if (names[i].empty()){
+            continue;
+        }
+        named = (std::min)(named, i);
+        hashes[i] = name_hash(names[i]);
+        buckets[i] = reduce_hash(hashes[i], N);
+        ++starts[buckets[i] + 1];
+    }
+    std::size_t max_bucket_size = 0;
+    for (std::size_t bucket = 0; bucket < N; ++bucket){
+        max_bucket_size = (std::max)(max_bucket_size, starts[bucket + 1]);
+        starts[bucket + 1] += starts[bucket];
+    }
+    std::array<std::size_t, N> members{};
+    std::array<std::size_t, N> filled{};
+    for (std::size_t i = 0; i < N; ++i){
+        if (!names[i].empty()){
+            members[starts[buckets[i]] + filled[buckets[i]]++] = i;
+        }
+    }
+
+    //largest buckets first, while most slots are still free
+    std::array<bool, N> taken{};
+    std::array<std::size_t, N> bucket_slots{};
+    for (std::size_t size = max_bucket_size; size > 0; --size){
+        for (std::size_t bucket = 0; bucket < N; ++bucket){
+            if (starts[bucket + 1] - starts[bucket] != size){
+                continue;
+            }
+            for (std::uint32_t seed = 0; ; ++seed){
+                std::size_t placed = 0;
+                for (; placed < size; ++placed){
+                    const std::size_t slot = NameHashTable<N>::slot(hashes[members[starts[bucket] + placed]], seed);
+                    bool free = !taken[slot];
+                    for (std::size_t j = 0; j < placed; ++j){
+                        free = free && bucket_slots[j] != slot;
+                    }
+                    if (!free){
+                        break;
+                    }
+                    bucket_slots[placed] = slot;
+                }
+                if (placed == size){
+                    for (std::size_t j = 0; j < size; ++j){
+                        taken[bucket_slots[j]] = true;
+                        table.slots[bucket_slots[j]] = static_cast<std::uint16_t>(members[starts[bucket] + j]);
+                    }
+                    table.seeds[bucket] = seed;
+                    break;
+                }
+            }
+        }
+    }
+    //the slots left free hold a named value, so that they never match an empty string
+    for (std::size_t slot = 0; slot < N; ++slot){
+        if (!taken[slot] && named < N){
+            table.slots[slot] = static_cast<std::uint16_t>(named);
+        }
+    }
+    return table;
+}
+
+template <typename E>
+inline constexpr auto name_hash_table_v = make_name_hash_table(names_v<E>);
+
 template <typename E, bool IsFlags = false, std::size_t... I>
 constexpr auto entries(std::index_sequence<I...>) noexcept {
     static_assert(std::is_enum_v<E>, "enum::entries requires enum type");
 
-    return std::array<std::pair<E, string_view>, sizeof...(I)>{{{values_v<E, IsFlags>[I], enum_name_v<E, values_v<E, IsFlags>[I]>}...}};
+    return std::array<std::pair<E, string_view>, sizeof...(I)>{{{values_v<E, IsFlags>[I], names_v<E, IsFlags>[I]}...}};
 }
 
 template <typename E, bool IsFlags = false>
@@ -430,14 +749,14 @@ using entries_t = decltype((entries_v<D, IsFlags>));
 template <typename E>
 [[nodiscard]] constexpr auto enum_name(E value) noexcept -> _enum::enable_if_enum_t<E, std::string_view> {
     using D = std::decay_t<E>;
+    using U = std::underlying_type_t<D>;
     //it is possible to static_cast an integral type to an enum value
     //without ensuring that it is associated with an enum name.
-    //need to ensure that the value provided actually corresponds to a valid enum name
-    if (const auto i = _enum::endex<D>(value); i != _enum::invalid_index_v<D>){
-        return _enum::names_v<D>[i];
-    }
-
-    return {}; //TODO: possible error handling needed?
+    //values without a name, and values out of range, which wrap around if they are below the minimum,
+    //are clamped to the index of an empty name
+    constexpr auto& names = _enum::value_names_v<D>;
+    const auto i = static_cast<std::size_t>(static_cast<U>(value) - _enum::min_v<D>);
+    return names[(std::min)(i, names.size() - 1)];
 }
 
 /**
@@ -520,14 +839,19 @@ template <typename E>
     return false;
 }
 
+/**
+ @brief Get the enum value named `str`, if there is one, through a minimal perfect hash of the names of the enum 
+ generated at compile time. 
+*/
 template <typename E>
 [[nodiscard]] constexpr auto enum_from_str(std::string_view str) -> std::optional<E> {
-    constexpr auto values = enum_values<E>();
-    
-    for (E value:values){
-        if (enum_name(value) == str){
-            return value;
-        }
+    using D = std::decay_t<E>;
+    static_assert(_enum::count_v<D> > 0, "Enum from string requires enum implementation and valid max and min.");
+
+    constexpr auto& table = _enum::name_hash_table_v<D>;
+    const std::size_t i = table.slots[table.slot(str)];
+    if (_enum::names_v<D>[i] == str){
+        return _enum::values_v<D>[i];
     }
     return std::nullopt;
 }
@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace houdini {
+namespace util {
+
+/**
+ * @brief Copy of the counts of a `LatencyHistogram` at one point in time. 
+ * Values are converted to nanoseconds with `ns_per_value`.
+ */
+template <std::size_t Buckets>
+struct HistogramSnapshot {
+	std::array<std::uint64_t, Buckets> counts{};
+	std::uint64_t count = 0;
+	std::uint64_t sum = 0;
+	double ns_per_value = 1.0;
+
+	/** 
+	 * @brief Upper bound, in nanoseconds, of the bucket containing the `p`th percentile (0 < p <= 100). 
+	 * Returns 0 if the histogram is empty.
+	 */
+	double percentile(double p) const;
+
+	double max() const {
+		return this->percentile(100.0);
+	}
+
+	double mean() const {
+		return this->count ? static_cast<double>(this->sum) * this->ns_per_value / static_cast<double>(this->count) : 0.0;
+	}
+};
+
+/**
+ * @brief Log-bucketed histogram in the style of HDR histograms. Each power of two is split into 
+ * `SUB_BUCKETS` linear buckets, so a bucket is at most 25% wider than its lower bound. 
+ * Values above 2^MAX_EXPONENT are counted in the last bucket.
+ * 
+ * @par The histogram has a single writer. `record` uses relaxed loads and stores rather than 
+ * read-modify-write operations, so it is cheap, and any thread may take a `snapshot` concurrently. 
+ * A snapshot taken during a write may miss that value, but counts are never torn.
+ */
+class LatencyHistogram {
+	public:
+		static constexpr std::size_t SUB_BUCKET_BITS = 2;
+		static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+		static constexpr std::size_t MAX_EXPONENT = 40;
+		static constexpr std::size_t BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+		using Snapshot = HistogramSnapshot<BUCKETS>;
+
+		static constexpr std::size_t bucketOf(std::uint64_t value) noexcept {
+			if (value < SUB_BUCKETS){
+				return value;
+			}
+			std::size_t exponent = 63 - static_cast<std::size_t>(__builtin_clzll(value));
+			if (exponent > MAX_EXPONENT){
+				return BUCKETS - 1;
+			}
+			const std::size_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+			return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+		}
+
+		/** @brief Largest value counted in `bucket`. */
+		static constexpr std::uint64_t upperBound(std::size_t bucket) noexcept {
+			if (bucket < SUB_BUCKETS){
+				return bucket;
+			}
+			const std::size_t shift = bucket / SUB_BUCKETS - 1;
+			const std::uint64_t base = SUB_BUCKETS + bucket % SUB_BUCKETS;
+			const std::uint64_t lower = base << shift;
+			return lower + (std::uint64_t{1} << shift) - 1;
+		}
+
+		void record(std::uint64_t value) noexcept {
+			auto& bucket = this->counts[bucketOf(value)];
+			bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			this->sum.store(this->sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		Snapshot snapshot(double ns_per_value = 1.0) const noexcept {
+			Snapshot result;
+			result.ns_per_value = ns_per_value;
+			for (std::size_t i = 0; i < BUCKETS; i++){
+				result.counts[i] = this->counts[i].load(std::memory_order_relaxed);
+				result.count += result.counts[i];
+			}
+			result.sum = this->sum.load(std::memory_order_relaxed);
+			return result;
+		}
+
+	private:
+		std::array<std::atomic<std::uint64_t>, BUCKETS> counts{};
+		std::atomic<std::uint64_t> sum{0};
+};
+
+template <std::size_t Buckets>
+double HistogramSnapshot<Buckets>::percentile(double p) const {
+	if (this->count == 0){
+		return 0.0;
+	}
+	const double rank = p / 100.0 * static_cast<double>(this->count);
+	std::uint64_t seen = 0;
+	std::size_t last = 0;
+	for (std::size_t i = 0; i < Buckets; i++){
+		if (this->counts[i] == 0){
+			continue;
+		}
+		seen += this->counts[i];
+		last = i;
+		if (static_cast<double>(seen) >= rank){
+			break;
+		}
+	}
+	return static_cast<double>(LatencyHistogram::upperBound(last)) * this->ns_per_value;
+}
+
+} //namespace util
+} //namespace houdini
@@ -0,0 +1,203 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace houdini {
+namespace util {
+
+/** @brief Values of the hardware counters read by `PerfCounterGroup`. */
+struct PerfSample {
+	std::uint64_t cycles = 0;
+	std::uint64_t instructions = 0;
+	std::uint64_t cache_misses = 0;
+	std::uint64_t branch_misses = 0;
+
+	PerfSample operator-(const PerfSample& other) const noexcept {
+		return {this->cycles - other.cycles, this->instructions - other.instructions,
+			this->cache_misses - other.cache_misses, this->branch_misses - other.branch_misses};
+	}
+};
+
+/**
+ * @brief Group of hardware performance counters (cycles, instructions, cache misses and branch misses)
+ * opened with `perf_event_open` for the calling thread, user space only. The counters are read
+ * together, so the values are consistent with each other. They only count the thread that opened
+ * them: code that may run on several threads should use `thisThread()`.
+ *
+ * @par The group is unavailable if the kernel or the machine does not provide these counters,
+ * for example on other platforms than Linux, in most virtual machines, or when `perf_event_paranoid`
+ * forbids it. Reads then fail and leave the sample untouched.
+ */
+class PerfCounterGroup {
+	public:
+		static constexpr std::size_t NUM_COUNTERS = 4;
+
+		PerfCounterGroup() noexcept {
+#if defined(__linux__)
+			constexpr std::array<std::uint64_t, NUM_COUNTERS> configs = {
+				PERF_COUNT_HW_CPU_CYCLES,
+				PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_MISSES,
+				PERF_COUNT_HW_BRANCH_MISSES
+			};
+			for (std::size_t i = 0; i < NUM_COUNTERS; i++){
+				perf_event_attr attr{};
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.size = sizeof(attr);
+				attr.config = configs[i];
+				attr.read_format = PERF_FORMAT_GROUP;
+				attr.disabled = i == 0 ? 1 : 0;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : this->fds[0], PERF_FLAG_FD_CLOEXEC);
+				if (fd < 0){
+					this->close();
+					return;
+				}
+				this->fds[i] = static_cast<int>(fd);
+			}
+			ioctl(this->fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(this->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+		}
+
+		PerfCounterGroup(const PerfCounterGroup&) = delete;
+		PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+		~PerfCounterGroup(){
+			this->close();
+		}
+
+		/** @brief The group of the calling thread, opened on first use and closed when the thread exits. */
+		static const PerfCounterGroup& thisThread() noexcept {
+			static thread_local const PerfCounterGroup group;
+			return group;
+		}
+
+		bool available() const noexcept {
+			return this->fds[0] >= 0;
+		}
+
+		/** @brief Read all counters. Returns false if the group is unavailable. */
+		bool read(PerfSample& sample) const noexcept {
+#if defined(__linux__)
+			if (!this->available()){
+				return false;
+			}
+			struct {
+				std::uint64_t nr;
+				std::array<std::uint64_t, NUM_COUNTERS> values;
+			} data{};
+			if (::read(this->fds[0], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))){
+				return false;
+			}
+			sample = {data.values[0], data.values[1], data.values[2], data.values[3]};
+			return true;
+#else
+			(void) sample;
+			return false;
+#endif
+		}
+
+	private:
+		void close() noexcept {
+#if defined(__linux__)
+			for (int& fd:this->fds){
+				if (fd >= 0){
+					::close(fd);
+					fd = -1;
+				}
+			}
+#endif
+		}
+
+		std::array<int, NUM_COUNTERS> fds{-1, -1, -1, -1};
+};
+
+/**
+ * @brief Snapshot of `PerfTotals`: counter values summed over `samples` measured sections.
+ */
+struct PerfSnapshot {
+	std::uint64_t samples = 0;
+	PerfSample totals;
+
+	/** @brief Instructions per cycle. */
+	double ipc() const noexcept {
+		return this->totals.cycles ? static_cast<double>(this->totals.instructions) / static_cast<double>(this->totals.cycles) : 0.0;
+	}
+};
+
+/**
+ * @brief Counter values summed over measured sections. Single writer; any thread may take a snapshot.
+ */
+class PerfTotals {
+	public:
+		void add(const PerfSample& delta) noexcept {
+			increment(this->samples, 1);
+			increment(this->cycles, delta.cycles);
+			increment(this->instructions, delta.instructions);
+			increment(this->cache_misses, delta.cache_misses);
+			increment(this->branch_misses, delta.branch_misses);
+		}
+
+		PerfSnapshot snapshot() const noexcept {
+			PerfSnapshot result;
+			result.samples = this->samples.load(std::memory_order_relaxed);
+			result.totals.cycles = this->cycles.load(std::memory_order_relaxed);
+			result.totals.instructions = this->instructions.load(std::memory_order_relaxed);
+			result.totals.cache_misses = this->cache_misses.load(std::memory_order_relaxed);
+			result.totals.branch_misses = this->branch_misses.load(std::memory_order_relaxed);
+			return result;
+		}
+
+	private:
+		static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		std::atomic<std::uint64_t> samples{0};
+		std::atomic<std::uint64_t> cycles{0};
+		std::atomic<std::uint64_t> instructions{0};
+		std::atomic<std::uint64_t> cache_misses{0};
+		std::atomic<std::uint64_t> branch_misses{0};
+};
+
+/**
+ * @brief Reads the counters when constructed and destroyed, and adds the difference to `totals`.
+ * Does nothing if the counter group is unavailable.
+ */
+class PerfScope {
+	public:
+		PerfScope(const PerfCounterGroup& group_, PerfTotals& totals_) noexcept
+		: group(group_), totals(totals_) {
+			this->active = this->group.read(this->start);
+		}
+
+		PerfScope(const PerfScope&) = delete;
+		PerfScope& operator=(const PerfScope&) = delete;
+
+		~PerfScope(){
+			PerfSample end;
+			if (this->active && this->group.read(end)){
+				this->totals.add(end - this->start);
+			}
+		}
+
+	private:
+		const PerfCounterGroup& group;
+		PerfTotals& totals;
+		PerfSample start;
+		bool active = false;
+};
+
+} //namespace util
+} //namespace houdini
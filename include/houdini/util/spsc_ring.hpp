@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace houdini {
+namespace util {
+
+/**
+ * @brief Lock-free, fixed-capacity ring buffer for exactly one producer thread and one consumer thread.
+ * 
+ * @par Pushing to a full ring fails: `push` returns false and the element is dropped, so the producer 
+ * never waits for the consumer. 
+ */
+template <typename T, std::size_t N>
+class SpscRing {
+	static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two.");
+	static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements must be trivially copyable.");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+
+		SpscRing() = default;
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		static constexpr size_type capacity() noexcept {
+			return N;
+		}
+
+		/** @brief Called by the producer only. */
+		bool push(const T& item) noexcept {
+			const size_type write = this->head.load(std::memory_order_relaxed);
+			if (write - this->cached_tail == N){
+				this->cached_tail = this->tail.load(std::memory_order_acquire);
+				if (write - this->cached_tail == N){
+					return false;
+				}
+			}
+			this->buffer[write & MASK] = item;
+			this->head.store(write + 1, std::memory_order_release);
+			return true;
+		}
+
+		/** @brief Called by the consumer only. */
+		bool pop(T& item) noexcept {
+			const size_type read = this->tail.load(std::memory_order_relaxed);
+			if (read == this->head.load(std::memory_order_acquire)){
+				return false;
+			}
+			item = this->buffer[read & MASK];
+			this->tail.store(read + 1, std::memory_order_release);
+			return true;
+		}
+
+		/** @brief Number of elements in the ring. Only exact when neither thread is modifying it. */
+		size_type size() const noexcept {
+			return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+		}
+
+		bool empty() const noexcept {
+			return this->size() == 0;
+		}
+
+	private:
+		static constexpr size_type MASK = N - 1;
+
+		//producer and consumer indices are kept on separate cache lines to avoid false sharing
+		alignas(64) std::atomic<size_type> head{0};
+		size_type cached_tail = 0;
+		alignas(64) std::atomic<size_type> tail{0};
+		alignas(64) std::array<T, N> buffer{};
+};
+
+} //namespace util
+} //namespace houdini
@@ -0,0 +1,130 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace houdini {
+namespace util {
+
+/**
+ * @brief Fixed-capacity FIFO queue backed by a ring buffer. Provides the subset of the 
+ * `std::queue` interface used by the framework, and never allocates. 
+ * 
+ * @par Pushing to a full queue fails: `push` returns false and the element is dropped. 
+ * Use `full()` to check beforehand.
+ */
+template <typename T, std::size_t N>
+class StaticQueue {
+	static_assert(N > 0, "StaticQueue requires a non-zero capacity.");
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using reference = T&;
+		using const_reference = const T&;
+
+		constexpr StaticQueue() = default;
+
+		/**
+		 * @brief Allocator-extended constructor, for interface compatibility with `JQueue`.
+		 * The allocator is ignored as the queue does not allocate.
+		 */
+		template <typename Alloc>
+		constexpr explicit StaticQueue(const Alloc&) {}
+
+		[[nodiscard]] constexpr bool empty() const noexcept {
+			return this->count == 0;
+		}
+
+		[[nodiscard]] constexpr bool full() const noexcept {
+			return this->count == N;
+		}
+
+		[[nodiscard]] constexpr size_type size() const noexcept {
+			return this->count;
+		}
+
+		static constexpr size_type capacity() noexcept {
+			return N;
+		}
+
+		constexpr bool push(const T& item){
+			if (this->full()){
+				return false;
+			}
+			this->buffer[this->tail] = item;
+			this->tail = next(this->tail);
+			this->count++;
+			return true;
+		}
+
+		constexpr bool push(T&& item){
+			if (this->full()){
+				return false;
+			}
+			this->buffer[this->tail] = std::move(item);
+			this->tail = next(this->tail);
+			this->count++;
+			return true;
+		}
+
+		constexpr void pop(){
+			assert(!this->empty() && "Queue underflow");
+			this->head = next(this->head);
+			this->count--;
+		}
+
+		[[nodiscard]] constexpr T& front() {
+			return this->buffer[this->head];
+		}
+
+		[[nodiscard]] constexpr const T& front() const {
+			return this->buffer[this->head];
+		}
+
+		[[nodiscard]] constexpr T& back() {
+			return this->buffer[prev(this->tail)];
+		}
+
+		[[nodiscard]] constexpr const T& back() const {
+			return this->buffer[prev(this->tail)];
+		}
+
+		constexpr void clear() noexcept {
+			this->head = 0;
+			this->tail = 0;
+			this->count = 0;
+		}
+
+	private:
+		static constexpr size_type next(size_type i) noexcept {
+			return (i + 1 == N) ? 0 : i + 1;
+		}
+
+		static constexpr size_type prev(size_type i) noexcept {
+			return (i == 0) ? N - 1 : i - 1;
+		}
+
+		std::array<T, N> buffer{};
+		size_type head = 0;
+		size_type tail = 0;
+		size_type count = 0;
+};
+
+/**
+ * @brief Returns true if no more elements can be pushed into the queue. 
+ * Unbounded queues are never full.
+ */
+template <typename Queue>
+constexpr bool is_full(const Queue&) noexcept {
+	return false;
+}
+
+template <typename T, std::size_t N>
+constexpr bool is_full(const StaticQueue<T, N>& queue) noexcept {
+	return queue.full();
+}
+
+} //namespace util
+} //namespace houdini
@@ -0,0 +1,45 @@
+#pragma once
+#include "houdini/util/types.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace houdini {
+namespace util {
+
+/**
+ * @brief Read the timestamp counter. On x86 this is the TSC, which costs a few nanoseconds to read.
+ * Elsewhere, the steady clock in nanoseconds is used instead.
+ */
+inline std::uint64_t read_ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Number of `read_ticks()` per microsecond. On x86 the TSC frequency is measured
+ * against the steady clock the first time this is called, which takes about 10ms.
+ */
+inline double ticks_per_microsecond(){
+#if defined(__x86_64__) || defined(__i386__)
+	static const double ticks_per_us = [](){
+		const auto start_time = SteadyClock::now();
+		const std::uint64_t start_ticks = read_ticks();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		const std::uint64_t end_ticks = read_ticks();
+		const auto elapsed = std::chrono::duration<double, std::micro>(SteadyClock::now() - start_time);
+		return static_cast<double>(end_ticks - start_ticks) / elapsed.count();
+	}();
+	return ticks_per_us;
+#else
+	return 1000.0;
+#endif
+}
+
+} //namespace util
+} //namespace houdini
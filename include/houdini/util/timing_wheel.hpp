@@ -0,0 +1,304 @@
+#pragma once
+#include "houdini/util/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace houdini {
+namespace util {
+
+class TimingWheel;
+
+/** @brief Links of the intrusive, circular lists that hold the timers of each wheel slot. */
+struct TimerLink {
+	TimerLink* prev = this;
+	TimerLink* next = this;
+
+	TimerLink() = default;
+	TimerLink(const TimerLink&) = delete;
+	TimerLink& operator=(const TimerLink&) = delete;
+
+	bool linked() const noexcept {
+		return this->next != this;
+	}
+
+	void unlink() noexcept {
+		this->prev->next = this->next;
+		this->next->prev = this->prev;
+		this->prev = this;
+		this->next = this;
+	}
+
+	/** @brief Insert `link` before this one, that is at the back of the list this link heads. */
+	void pushBack(TimerLink& link) noexcept {
+		link.prev = this->prev;
+		link.next = this;
+		this->prev->next = &link;
+		this->prev = &link;
+	}
+};
+
+/**
+ * @brief A timer that can be armed in a `TimingWheel`. Timers are owned by their user, not by the wheel,
+ * so arming and cancelling never allocates. `callback(*this)` is called when the timer expires, after it has
+ * been removed from the wheel, so the callback may arm it again.
+ *
+ * @par A timer that is destroyed while armed is cancelled.
+ */
+struct TimerNode : TimerLink {
+	void (*callback)(TimerNode&) = nullptr;
+	void* context = nullptr;
+	std::size_t id = 0;
+
+	TimerNode() = default;
+	TimerNode(void (*callback_)(TimerNode&), void* context_, std::size_t id_) noexcept
+	: callback(callback_), context(context_), id(id_) {}
+
+	~TimerNode();
+
+	bool armed() const noexcept {
+		return this->wheel != nullptr;
+	}
+
+	private:
+		friend class TimingWheel;
+		TimingWheel* wheel = nullptr;
+		std::uint64_t expiry = 0;
+		std::uint8_t level = 0;
+		std::uint8_t slot = 0;
+};
+
+/**
+ * @brief Hierarchical timing wheel. Timers are armed and cancelled in O(1), whatever the number of timers armed,
+ * and expire in order of their expiry tick when the wheel is advanced.
+ *
+ * @par The wheel has 4 levels of 64 slots. The first level holds timers that expire within 64 ticks, each
+ * following level holds timers 64 times further away, and timers are moved down a level as their expiry nears.
+ * Delays longer than the last level (2^24 ticks, about 4.6 hours with the default 1ms tick) are supported,
+ * but such timers are moved around the last level until they are due.
+ *
+ * @par The wheel does not read a clock: time only moves when `advance` is called, so it can be driven
+ * by a simulated clock. The first call to `advance` sets the time of tick 0; timers armed before it count from then.
+ */
+class TimingWheel {
+	public:
+		static constexpr std::size_t LEVELS = 4;
+		static constexpr std::size_t SLOT_BITS = 6;
+		static constexpr std::size_t SLOTS = std::size_t{1} << SLOT_BITS;
+		static constexpr std::uint64_t MAX_DELAY_TICKS = (std::uint64_t{1} << (LEVELS * SLOT_BITS)) - 1;
+
+		explicit TimingWheel(std::chrono::nanoseconds tick_ = std::chrono::milliseconds(1)) noexcept
+		: tick(tick_) {
+			assert(tick_.count() > 0 && "Timing wheel tick must be positive.");
+		}
+
+		TimingWheel(const TimingWheel&) = delete;
+		TimingWheel& operator=(const TimingWheel&) = delete;
+
+		/** @brief Timers still armed are left unarmed, without their callback being called. */
+		~TimingWheel(){
+			for (auto& level:this->slots){
+				for (TimerLink& head:level){
+					while (head.linked()){
+						TimerNode& node = static_cast<TimerNode&>(*head.next);
+						node.unlink();
+						node.wheel = nullptr;
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Arm `node` to expire `delay` from the current time of the wheel, rounded up to a whole number of ticks.
+		 * A node that is already armed is re-armed.
+		 */
+		void arm(TimerNode& node, std::chrono::nanoseconds delay) noexcept {
+			const auto ticks = (delay.count() + this->tick.count() - 1) / this->tick.count();
+			this->armTicks(node, ticks > 0 ? static_cast<std::uint64_t>(ticks) : 1);
+		}
+
+		void cancel(TimerNode& node) noexcept {
+			if (node.wheel){
+				assert(node.wheel == this && "Timer is armed in another wheel.");
+				this->remove(node);
+			}
+		}
+
+		/**
+		 * @brief Move the wheel forward to `now`, calling the callback of every timer that expires on the way,
+		 * in order of expiry.
+		 *
+		 * @return the number of timers that expired.
+		 */
+		std::size_t advance(TimePoint now){
+			if (!this->started){
+				this->started = true;
+				this->origin = now;
+				return 0;
+			}
+			if (now < this->origin){
+				return 0;
+			}
+			const std::uint64_t target = static_cast<std::uint64_t>((now - this->origin) / this->tick);
+			std::size_t expired = 0;
+			while (this->current < target){
+				if (this->count == 0){
+					this->current = target;
+					break;
+				}
+				//nothing happens before the next tick at which the lowest occupied level cascades
+				std::size_t level = 0;
+				while (level < LEVELS && this->occupied[level] == 0){
+					level++;
+				}
+				if (level > 0){
+					const std::uint64_t span = std::uint64_t{1} << (level * SLOT_BITS);
+					const std::uint64_t boundary = (this->current / span + 1) * span;
+					if (boundary > this->current + 1){
+						this->current = std::min(boundary, target + 1) - 1;
+						continue;
+					}
+				}
+				this->current++;
+				expired += this->expire();
+			}
+			return expired;
+		}
+
+		/**
+		 * @brief The time at which the wheel next needs to be advanced, `TimePoint::max()` if no timer is armed
+		 * and `TimePoint::min()` if timers are armed but the wheel has not been advanced yet.
+		 * Timers more than 64 ticks away are only due once they have been moved down to the first level,
+		 * so this may be earlier than the expiry of the earliest timer.
+		 */
+		TimePoint nextDue() const noexcept {
+			if (this->count == 0){
+				return TimePoint::max();
+			}
+			if (!this->started){
+				return TimePoint::min();
+			}
+			std::uint64_t due = UINT64_MAX;
+			for (std::size_t level = 0; level < LEVELS; level++){
+				const std::uint64_t bits = this->occupied[level];
+				if (bits == 0){
+					continue;
+				}
+				//distance in slots, from 1 to 64, of the first occupied slot after the current one
+				const std::size_t shift = level * SLOT_BITS;
+				const std::size_t index = (this->current >> shift) & (SLOTS - 1);
+				const std::size_t rotation = (index + 1) & (SLOTS - 1);
+				const std::uint64_t rotated = rotation ? (bits >> rotation) | (bits << (SLOTS - rotation)) : bits;
+				const std::uint64_t distance = static_cast<std::uint64_t>(__builtin_ctzll(rotated)) + 1;
+				due = std::min(due, ((this->current >> shift) + distance) << shift);
+			}
+			return this->origin + this->tick * static_cast<std::int64_t>(due);
+		}
+
+		/** @brief Number of timers armed. */
+		std::size_t size() const noexcept {
+			return this->count;
+		}
+
+		bool empty() const noexcept {
+			return this->count == 0;
+		}
+
+		std::chrono::nanoseconds tickDuration() const noexcept {
+			return this->tick;
+		}
+
+	private:
+		void armTicks(TimerNode& node, std::uint64_t ticks) noexcept {
+			this->cancel(node);
+			node.expiry = this->current + ticks;
+			node.wheel = this;
+			this->count++;
+			this->insert(node);
+		}
+
+		void insert(TimerNode& node) noexcept {
+			const std::uint64_t delta = std::min(node.expiry - this->current, MAX_DELAY_TICKS);
+			std::size_t level = 0;
+			while (level + 1 < LEVELS && delta >= (std::uint64_t{1} << ((level + 1) * SLOT_BITS))){
+				level++;
+			}
+			const std::uint64_t position = level + 1 < LEVELS ? node.expiry : this->current + delta;
+			const std::size_t slot = (position >> (level * SLOT_BITS)) & (SLOTS - 1);
+			node.level = static_cast<std::uint8_t>(level);
+			node.slot = static_cast<std::uint8_t>(slot);
+			this->slots[level][slot].pushBack(node);
+			this->occupied[level] |= std::uint64_t{1} << slot;
+		}
+
+		void remove(TimerNode& node) noexcept {
+			TimerLink& head = this->slots[node.level][node.slot];
+			node.unlink();
+			if (!head.linked()){
+				this->occupied[node.level] &= ~(std::uint64_t{1} << node.slot);
+			}
+			node.wheel = nullptr;
+			this->count--;
+		}
+
+		/** @brief Cascade the slots of the higher levels that come due at the current tick, then expire the timers of the first level. */
+		std::size_t expire(){
+			for (std::size_t level = LEVELS - 1; level > 0; level--){
+				const std::uint64_t mask = (std::uint64_t{1} << (level * SLOT_BITS)) - 1;
+				if ((this->current & mask) == 0){
+					this->cascade(level, (this->current >> (level * SLOT_BITS)) & (SLOTS - 1));
+				}
+			}
+
+			const std::size_t slot = this->current & (SLOTS - 1);
+			TimerLink& head = this->slots[0][slot];
+			std::size_t expired = 0;
+			while (head.linked()){
+				TimerNode& node = static_cast<TimerNode&>(*head.next);
+				this->remove(node);
+				expired++;
+				if (node.callback){
+					//the callback may arm or cancel any timer, including this one
+					node.callback(node);
+				}
+			}
+			return expired;
+		}
+
+		void cascade(std::size_t level, std::size_t slot) noexcept {
+			TimerLink& head = this->slots[level][slot];
+			TimerLink pending;
+			while (head.linked()){
+				TimerLink& link = *head.next;
+				link.unlink();
+				pending.pushBack(link);
+			}
+			this->occupied[level] &= ~(std::uint64_t{1} << slot);
+			while (pending.linked()){
+				TimerNode& node = static_cast<TimerNode&>(*pending.next);
+				node.unlink();
+				this->insert(node);
+			}
+		}
+
+		std::array<std::array<TimerLink, SLOTS>, LEVELS> slots{};
+		std::array<std::uint64_t, LEVELS> occupied{};
+		std::chrono::nanoseconds tick;
+		TimePoint origin{};
+		std::uint64_t current = 0;
+		std::size_t count = 0;
+		bool started = false;
+};
+
+inline TimerNode::~TimerNode(){
+	if (this->wheel){
+		this->wheel->cancel(*this);
+	}
+}
+
+} //namespace util
+} //namespace houdini
@@ -1,5 +1,10 @@
 #pragma once
 //#include <houdini/memory/tlsf_resource.hpp>
+#include "houdini/memory/allocate_unique.hpp"
+#include "houdini/util/constants.hpp"
+#include "houdini/util/static_queue.hpp"
+
+#include <deque>
 #include <limits>
 #include <vector>
 #include <queue>
@@ -21,8 +26,18 @@ using JUnorderedMap = std::unordered_map<K,V,Hash,KeyEqual,JAllocator<std::pair<
 template <typename T>
 using JVector = std::pmr::vector<T>;
 
+//with JANUS_STATIC_QUEUES defined, event queues have a fixed capacity and never allocate.
+//this is required for state machines and actors to perform no heap allocations after construction.
+#ifdef JANUS_STATIC_QUEUES
+template <typename T>
+using JQueue = util::StaticQueue<T, JANUS_STATIC_QUEUE_CAPACITY>;
+#else
 template <typename T>
-using JQueue = std::queue<T>;
+using JQueue = std::queue<T, std::pmr::deque<T>>;
+#endif
+
+template <typename T>
+using JUniquePtr = memory::pmr_unique_ptr<T>;
 
 template <typename... T>
 using JVariant = std::variant<T...>;
@@ -31,6 +46,11 @@ using msTimeDuration = std::chrono::milliseconds;
 using usTimeDuration = std::chrono::microseconds;
 using TimeDuration = msTimeDuration;
 
+//all time points passed through the framework are expressed on this clock. 
+//simulated clocks reuse its time_point so state machines are agnostic to the time source.
+using SteadyClock = std::chrono::steady_clock;
+using TimePoint = SteadyClock::time_point;
+
 using JEvent = uint16_t;
 using JCommand = JEvent;
 using JErrorFlag = uint16_t;
@@ -2,6 +2,8 @@
 #include <algorithm>
 #include <type_traits>
 #include <array>
+#include <cstddef>
+#include <utility>
 
 namespace houdini {
 namespace util {
@@ -31,6 +33,25 @@ constexpr Array<T,N> fill_array(const Array<T,N>& arr, T value){
 	return arr2; 
 }
 
+namespace detail {
+template <typename T, typename Generator, std::size_t... I>
+constexpr std::array<T, sizeof...(I)> generate_array_impl(Generator& generator, std::index_sequence<I...>){
+	return {{((void)I, generator())...}};
+}
+} //namespace detail
+
+/**
+ * @brief Creates an array whose elements are each initialized directly from the result of `generator()`.
+ * 
+ * @par Unlike filling or copying an array, each element is constructed in place. This is required 
+ * for arrays of allocator-aware containers: a `std::pmr` container keeps the allocator it was constructed 
+ * with and does not pick up a new one on copy or assignment.
+ */
+template <typename T, std::size_t N, typename Generator>
+constexpr std::array<T, N> generate_array(Generator&& generator){
+	return detail::generate_array_impl<T>(generator, std::make_index_sequence<N>{});
+}
+
 /**
  @brief constexpr version of std::transform (std::transform is only constexpr from C++20 onwards)
 */
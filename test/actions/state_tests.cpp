@@ -42,4 +42,69 @@ TEST(StateTests, virtualFunctionsShouldOverride){
 	s1->onExitImpl(context, broker);
 	
 	EXPECT_EQ(context.i, 1);
-}
\ No newline at end of file
+}
+
+struct PlainState : State {};
+
+struct PrivateHookState : State {
+	private:
+		void onExit(Context& context, Broker&) override {
+			context.k++;
+		}
+};
+
+struct CountingBehavior : houdini::Behavior<Context, Broker> {
+	CountingBehavior() : houdini::Behavior<Context, Broker>(1) {}
+
+	void onEntry(Context& context, Broker&) override {
+		context.k += 10;
+	}
+
+	void update(Context& context, Broker&) override {
+		context.k += 100;
+	}
+};
+
+struct BehaviorState : State {
+	houdini::Behaviors<CountingBehavior, CountingBehavior> behaviors;
+};
+
+TEST(StateTests, hooksAreDetectedAtCompileTime){
+	using houdini::sm::StateAccess;
+	using Storage = std::tuple<PlainState, TestState, PrivateHookState>;
+
+	constexpr auto plain = StateAccess::hooks<0, Storage, Context, Broker>();
+	static_assert(plain.entry == nullptr && plain.exit == nullptr && plain.update == nullptr);
+
+	static_assert(StateAccess::overridesOnEntry<TestState, Context, Broker>());
+	static_assert(StateAccess::overridesOnExit<TestState, Context, Broker>());
+	static_assert(!StateAccess::overridesUpdate<TestState, Context, Broker>());
+
+	constexpr auto private_hook = StateAccess::hooks<2, Storage, Context, Broker>();
+	static_assert(private_hook.entry == nullptr);
+	static_assert(StateAccess::overridesOnExit<PrivateHookState, Context, Broker>());
+
+	static_assert(StateAccess::hasBehaviors<BehaviorState>());
+	static_assert(!StateAccess::hasBehaviors<TestState>());
+
+	Context context;
+	Broker broker;
+	Storage states;
+	private_hook.exit(states, context, broker);
+	EXPECT_EQ(context.k, 1);
+}
+
+TEST(StateTests, behaviorsAreCalledInPlace){
+	using Storage = std::tuple<BehaviorState>;
+	constexpr auto hooks = houdini::sm::StateAccess::hooks<0, Storage, Context, Broker>();
+	Context context;
+	Broker broker;
+	Storage states;
+
+	hooks.entry(states, context, broker);
+	EXPECT_EQ(context.k, 20);
+
+	hooks.update(states, context, broker, houdini::TimePoint{} + std::chrono::seconds(1));
+	EXPECT_EQ(context.k, 220);
+	EXPECT_EQ(context.i, 0);
+}
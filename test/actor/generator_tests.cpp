@@ -0,0 +1,135 @@
+#include "houdini/houdini.hpp"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace houdini;
+using namespace std::chrono_literals;
+
+namespace {
+
+enum BeatEvents : JEvent {
+    heartbeat,
+    poll,
+    overload
+};
+
+JANUS_CREATE_EVENT(BeatEvents, beat);
+
+using BeatBroker = brokers::MessageBroker<BeatEvents>;
+
+std::vector<BeatEvents> drain(BeatBroker& broker){
+    std::vector<BeatEvents> events;
+    while (broker.hasEvents()){
+        events.push_back(broker.getFirstEvent());
+    }
+    return events;
+}
+
+bool isOverloaded(void* load){
+    return *static_cast<int*>(load) > 80;
+}
+
+struct BeatContext : act::BaseContext {
+    int heartbeats = 0;
+};
+
+struct CountBeat {
+    void operator()(JEvent, BeatContext& context, BeatBroker&) const {
+        context.heartbeats++;
+    }
+};
+
+struct Alive : State<BeatContext, BeatBroker> {};
+
+struct BeatRoot : State<BeatContext, BeatBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        return transition_table(
+            *state<Alive> + beat<heartbeat> / CountBeat{} = state<Alive>
+        );
+        //clang-format on
+    }
+};
+
+class BeatActor : public Actor<BeatEvents, BeatRoot, BeatContext, BeatBroker> {
+    public:
+        BeatActor() : Actor(BeatContext(), 1h) {}
+
+        BeatBroker& broker(){
+            return this->message_broker;
+        }
+
+        const BeatContext& context() const {
+            return this->execution_context;
+        }
+};
+
+} //namespace
+
+TEST(GeneratorTests, generatorsWithTheSamePeriodShareAWakeup){
+    BeatBroker broker;
+    broker.pollGenerators(TimePoint{});
+    ASSERT_TRUE(broker.addGenerator(heartbeat, 100ms));
+    ASSERT_TRUE(broker.addGenerator(poll, 100ms));
+    ASSERT_TRUE(broker.addGenerator(overload, 250ms));
+    EXPECT_EQ(broker.generatorGroups(), 2);
+
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 99ms), 0);
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 100ms), 2);
+    EXPECT_EQ(drain(broker), (std::vector<BeatEvents>{heartbeat, poll}));
+
+    //events of all the wakeups that were missed are queued
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 300ms), 5);
+    EXPECT_EQ(drain(broker), (std::vector<BeatEvents>{heartbeat, poll, overload, heartbeat, poll}));
+}
+
+TEST(GeneratorTests, conditionsAreCheckedOnEachPeriod){
+    BeatBroker broker;
+    int load = 50;
+    broker.pollGenerators(TimePoint{});
+    ASSERT_TRUE(broker.addGenerator(overload, 10ms, &isOverloaded, &load));
+
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 30ms), 0);
+    load = 90;
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 50ms), 2);
+    EXPECT_EQ(broker.getNumEvents(), 2);
+}
+
+TEST(GeneratorTests, removedGeneratorsStopGenerating){
+    BeatBroker broker;
+    broker.pollGenerators(TimePoint{});
+    const auto first = broker.addGenerator(heartbeat, 100ms);
+    const auto second = broker.addGenerator(poll, 100ms);
+    ASSERT_TRUE(first && second);
+
+    broker.removeGenerator(*first);
+    EXPECT_EQ(broker.generatorGroups(), 1);
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 100ms), 1);
+    broker.removeGenerator(*second);
+    EXPECT_EQ(broker.generatorGroups(), 0);
+    EXPECT_EQ(broker.nextGeneratorDue(), TimePoint::max());
+    EXPECT_EQ(broker.pollGenerators(TimePoint{} + 1s), 0);
+}
+
+TEST(GeneratorTests, generatorsAreLimited){
+    BeatBroker broker;
+    for (int i = 0; i < JANUS_MAX_GENERATORS; i++){
+        ASSERT_TRUE(broker.addGenerator(heartbeat, std::chrono::milliseconds(i + 1)));
+    }
+    EXPECT_FALSE(broker.addGenerator(heartbeat, 1ms));
+    EXPECT_FALSE(BeatBroker().addGenerator(heartbeat, 0ms));
+}
+
+TEST(GeneratorTests, actorsRunGeneratorsInVirtualTime){
+    BeatActor actor;
+    SimulationExecutor executor;
+    executor.add(actor);
+    actor.broker().addGenerator(heartbeat, 1s);
+
+    executor.runFor(1min);
+    EXPECT_EQ(actor.context().heartbeats, 60);
+    //the actor wakes up at most twice per heartbeat: as the timer nears its expiry, then when it expires
+    EXPECT_LE(executor.runFor(1min), 2 * 60 + 1);
+}
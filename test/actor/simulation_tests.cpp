@@ -0,0 +1,188 @@
+#include "houdini/houdini.hpp"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace houdini;
+using namespace std::chrono_literals;
+
+namespace {
+
+enum SimEvents : JEvent {
+    go,
+    back,
+    halt
+};
+
+JANUS_CREATE_EVENT(SimEvents, event);
+
+struct SimContext : act::BaseContext {
+    int updates = 0;
+    int transitions = 0;
+};
+
+using SimBroker = brokers::MessageBroker<SimEvents>;
+
+struct Count {
+    void operator()(JEvent, SimContext& context, SimBroker&) const {
+        context.transitions++;
+    }
+};
+
+struct Stop {
+    void operator()(JEvent, SimContext& context, SimBroker&) const {
+        context.stop_flag = true;
+    }
+};
+
+struct Polling : State<SimContext, SimBroker> {
+    Polling() : State<SimContext, SimBroker>(100) {}
+
+    void update(SimContext& context, SimBroker&) override {
+        context.updates++;
+    }
+};
+
+struct Waiting : State<SimContext, SimBroker> {};
+
+struct SimRoot : State<SimContext, SimBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        return transition_table(
+            *state<Polling> + event<go> / Count{}   = state<Waiting>,
+             state<Waiting> + event<back> / Count{} = state<Polling>,
+             state<Polling> + event<halt> / Stop{}  = state<Polling>
+        );
+        //clang-format on
+    }
+};
+
+class SimActor : public Actor<SimEvents, SimRoot, SimContext, SimBroker> {
+    public:
+        SimActor() : Actor(SimContext(), 50ms) {}
+
+        bool post(SimEvents event){
+            return this->message_broker.queueEvent(event);
+        }
+
+        const SimContext& context() const {
+            return this->execution_context;
+        }
+};
+
+struct Cooldown : State<SimContext, SimBroker> {};
+
+struct TimedRoot : State<SimContext, SimBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        return transition_table(
+            *state<Waiting>  + event<go>               = state<Cooldown>,
+             state<Cooldown> + after<250> / Count{}    = state<Waiting>
+        );
+        //clang-format on
+    }
+};
+
+class TimedActor : public Actor<SimEvents, TimedRoot, SimContext, SimBroker> {
+    public:
+        TimedActor() : Actor(SimContext(), 1h) {}
+
+        bool post(SimEvents event){
+            return this->message_broker.queueEvent(event);
+        }
+
+        const SimContext& context() const {
+            return this->execution_context;
+        }
+};
+
+} //namespace
+
+TEST(SimulationExecutorTests, virtualTimeAdvancesWithoutWaiting){
+    SimActor actor;
+    SimulationExecutor executor;
+    executor.add(actor);
+
+    auto start = std::chrono::steady_clock::now();
+    //actor updates every 50ms from t = 0 to t = 10min
+    std::size_t steps = executor.runFor(10min);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(steps, 12001u);
+    //the state updates every 100ms, starting one period after the epoch
+    EXPECT_EQ(actor.context().updates, 6000);
+    EXPECT_EQ(executor.now(), TimePoint{} + 10min);
+    EXPECT_LT(elapsed, 10s);
+}
+
+TEST(SimulationExecutorTests, eventsAreProcessedAtCurrentVirtualTime){
+    SimActor actor;
+    SimulationExecutor executor;
+    executor.add(actor);
+
+    executor.runFor(25ms);
+    actor.post(go);
+    actor.post(back);
+    actor.post(go);
+    EXPECT_EQ(actor.nextDue(), TimePoint::min());
+
+    executor.runFor(0ms);
+    EXPECT_EQ(actor.context().transitions, 3);
+    EXPECT_EQ(executor.now(), TimePoint{} + 25ms);
+    EXPECT_EQ(actor.nextDue(), TimePoint{} + 50ms);
+}
+
+TEST(SimulationExecutorTests, stoppedActorsAreNotStepped){
+    SimActor actor;
+    SimulationExecutor executor;
+    executor.add(actor);
+
+    actor.post(halt);
+    actor.post(go);
+    executor.runFor(1s);
+
+    EXPECT_EQ(actor.status(), act::ActorStatus::STOP);
+    EXPECT_EQ(actor.context().transitions, 0);
+    EXPECT_EQ(actor.nextDue(), TimePoint::max());
+    EXPECT_EQ(executor.now(), TimePoint{} + 1s);
+}
+
+TEST(SimulationExecutorTests, manyActorsRunDeterministically){
+    constexpr std::size_t num_actors = 1000;
+    std::vector<std::unique_ptr<SimActor>> actors;
+    SimulationExecutor executor;
+    for (std::size_t i = 0; i < num_actors; i++){
+        actors.push_back(std::make_unique<SimActor>());
+        executor.add(*actors.back());
+    }
+    //only even actors leave the polling state
+    for (std::size_t i = 0; i < num_actors; i += 2){
+        actors[i]->post(go);
+    }
+
+    executor.runFor(1min);
+    for (std::size_t i = 0; i < num_actors; i++){
+        EXPECT_EQ(actors[i]->context().updates, i % 2 == 0 ? 0 : 600);
+    }
+}
+
+TEST(SimulationExecutorTests, timersFireAtTheirVirtualTime){
+    TimedActor actor;
+    SimulationExecutor executor;
+    executor.add(actor);
+
+    executor.runFor(10ms);
+    actor.post(go);
+    executor.runFor(0ms);
+    //the actor is woken up when the timer nears its expiry
+    EXPECT_GT(actor.nextDue(), TimePoint{} + 200ms);
+    EXPECT_LE(actor.nextDue(), TimePoint{} + 260ms);
+
+    executor.runFor(249ms);
+    EXPECT_EQ(actor.context().transitions, 0);
+    executor.runFor(1ms);
+    EXPECT_EQ(actor.context().transitions, 1);
+    EXPECT_EQ(actor.nextDue(), TimePoint{} + 1h);
+}
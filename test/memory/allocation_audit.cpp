@@ -0,0 +1,169 @@
+#include "allocation_audit.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> audit_active{false};
+std::atomic<std::size_t> allocation_count{0};
+std::atomic<std::size_t> allocation_bytes{0};
+
+void record(std::size_t size) noexcept {
+	if (audit_active.load(std::memory_order_relaxed)){
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+}
+
+} //namespace
+
+AllocationAudit::AllocationAudit(){
+	allocation_count = 0;
+	allocation_bytes = 0;
+	audit_active = true;
+}
+
+AllocationAudit::~AllocationAudit(){
+	audit_active = false;
+}
+
+std::size_t AllocationAudit::allocations() const {
+	return allocation_count.load();
+}
+
+std::size_t AllocationAudit::bytes() const {
+	return allocation_bytes.load();
+}
+
+// C allocation functions. glibc exposes its implementation under __libc_* names, 
+// which lets us interpose on malloc without reimplementing it. 
+// Interposing is incompatible with the address sanitizer, which replaces these itself.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t n, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size){
+	record(size);
+	return __libc_malloc(size);
+}
+
+void* calloc(std::size_t n, std::size_t size){
+	record(n*size);
+	return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, std::size_t size){
+	record(size);
+	return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size){
+	record(size);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size){
+	record(size);
+	void* p = __libc_memalign(alignment, size);
+	if (!p){
+		return ENOMEM;
+	}
+	*ptr = p;
+	return 0;
+}
+
+void free(void* ptr){
+	__libc_free(ptr);
+}
+} //extern "C"
+#endif
+
+// C++ allocation functions. These are replaced regardless of the C library, and do not 
+// call the functions above so each allocation is only counted once.
+namespace {
+
+void* allocate(std::size_t size){
+	record(size);
+	if (size == 0){
+		size = 1;
+	}
+	while (true){
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+		void* p = __libc_malloc(size);
+#else
+		void* p = std::malloc(size);
+#endif
+		if (p){
+			return p;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (!handler){
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment){
+	record(size);
+	std::size_t align = static_cast<std::size_t>(alignment);
+	//aligned_alloc requires the size to be a multiple of the alignment
+	std::size_t rounded = ((size + align - 1) / align) * align;
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+	void* p = __libc_memalign(align, rounded);
+#else
+	void* p = std::aligned_alloc(align, rounded);
+#endif
+	if (!p){
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void deallocate(void* p) noexcept {
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+	__libc_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+} //namespace
+
+void* operator new(std::size_t size){ return allocate(size); }
+void* operator new[](std::size_t size){ return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment){ return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment){ return allocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try { return allocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try { return allocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(p); }
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Counts heap allocations made by the process while it is alive. 
+ * 
+ * Linking `allocation_audit.cpp` into a test executable replaces the global `operator new` 
+ * (all forms) and, on glibc, `malloc`/`calloc`/`realloc`/`aligned_alloc`/`posix_memalign`, 
+ * so that every heap allocation is counted while an audit is active. 
+ * Audits must not be nested.
+ */
+class AllocationAudit {
+	public:
+		AllocationAudit();
+		~AllocationAudit();
+
+		AllocationAudit(const AllocationAudit&) = delete;
+		AllocationAudit& operator=(const AllocationAudit&) = delete;
+
+		/** @brief Number of allocations made since the audit started. */
+		std::size_t allocations() const;
+
+		/** @brief Number of bytes requested since the audit started. */
+		std::size_t bytes() const;
+};
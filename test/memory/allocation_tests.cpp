@@ -0,0 +1,164 @@
+#include "houdini/houdini.hpp"
+#include "houdini/memory/allocate_unique.hpp"
+#include "houdini/memory/scoped_resource.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * Memory resource that forwards to an upstream resource and keeps track of 
+ * the number of bytes and blocks that are outstanding. 
+ */
+class CountingResource : public std::pmr::memory_resource {
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream_ = std::pmr::new_delete_resource())
+		: upstream(upstream_) {}
+
+		std::size_t allocations = 0;
+		std::size_t outstanding_blocks = 0;
+		std::size_t outstanding_bytes = 0;
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			allocations++;
+			outstanding_blocks++;
+			outstanding_bytes += bytes;
+			return upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+			outstanding_blocks--;
+			outstanding_bytes -= bytes;
+			upstream->deallocate(p, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		std::pmr::memory_resource* upstream;
+};
+
+/**
+ * Installs the null memory resource as the default resource, so that anything that 
+ * silently falls back to the default resource throws `std::bad_alloc`.
+ */
+class NullDefaultResource {
+	public:
+		NullDefaultResource() : previous(std::pmr::set_default_resource(std::pmr::null_memory_resource())) {}
+		~NullDefaultResource(){ std::pmr::set_default_resource(previous); }
+	private:
+		std::pmr::memory_resource* previous;
+};
+
+enum Events : houdini::JEvent {
+	e1,
+	e2
+};
+
+JANUS_CREATE_EVENT(Events, event);
+
+using Broker = houdini::brokers::MessageBroker<Events>;
+using Context = houdini::act::BaseContext;
+
+struct CountingBehavior : houdini::Behavior<Context, Broker> {
+	int* entries = nullptr;
+	explicit CountingBehavior(int* entries_) : entries(entries_) {}
+
+	void onEntry(Context&, Broker&) override {
+		(*entries)++;
+	}
+};
+
+inline int behavior_entries = 0;
+
+struct S1 : houdini::State<Context, Broker> {};
+struct S2 : houdini::State<Context, Broker> {
+	houdini::Behaviors<CountingBehavior> behaviors{CountingBehavior{&behavior_entries}};
+};
+
+struct Root : houdini::State<Context, Broker> {
+	static constexpr auto make_transition_table(){
+		//clang-format off
+		using namespace houdini;
+		return transition_table(
+			*state<S1> + event<e1> = state<S2>,
+			 state<S2> + event<e2> = state<S1>
+		);
+		//clang-format on
+	}
+};
+
+using TestSM = houdini::SM<Root, Events, Context, Broker>;
+
+TEST(AllocationTests, allocateUniqueUsesResource){
+	CountingResource resource;
+	{
+		auto ptr = houdini::memory::allocate_unique<int>(houdini::JAllocator<std::byte>(&resource), 5);
+		EXPECT_EQ(*ptr, 5);
+		EXPECT_EQ(resource.outstanding_blocks, 1u);
+		EXPECT_EQ(resource.outstanding_bytes, sizeof(int));
+	}
+	EXPECT_EQ(resource.outstanding_blocks, 0u);
+}
+
+TEST(AllocationTests, allocateUniqueConvertsToBase){
+	CountingResource resource;
+	{
+		houdini::memory::ResourceScope scope(&resource);
+		houdini::JUniquePtr<houdini::State<Context, Broker>> state = 
+			houdini::memory::allocate_unique<S2>(houdini::JAllocator<std::byte>(&resource));
+		EXPECT_EQ(resource.outstanding_bytes, sizeof(S2)) << "Behaviors of S2 are stored in place";
+	}
+	EXPECT_EQ(resource.outstanding_blocks, 0u);
+	EXPECT_EQ(resource.outstanding_bytes, 0u);
+}
+
+TEST(AllocationTests, stateMachineAllocatesOnlyFromSuppliedResource){
+	CountingResource resource;
+	Context context;
+	Broker broker;
+	{
+		NullDefaultResource guard;
+		TestSM state_machine(std::allocator_arg, houdini::JAllocator<std::byte>(&resource), context, broker);
+		EXPECT_GT(resource.allocations, 0u);
+
+		behavior_entries = 0;
+		state_machine.processEvent(e1);
+		EXPECT_TRUE(state_machine.is(houdini::state<S2>));
+		EXPECT_EQ(behavior_entries, 1);
+	}
+	EXPECT_EQ(resource.outstanding_blocks, 0u) << "Everything is returned to the resource on destruction";
+}
+
+TEST(AllocationTests, actorAllocatesOnlyFromSuppliedResource){
+	CountingResource resource;
+	{
+		NullDefaultResource guard;
+		houdini::act::Actor<Events, Root, Context, Broker> actor(&resource);
+		EXPECT_GT(resource.allocations, 0u);
+	}
+	EXPECT_EQ(resource.outstanding_blocks, 0u);
+}
+
+TEST(AllocationTests, actorFitsInMonotonicArena){
+	std::array<std::byte, 1 << 16> buffer;
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+	houdini::act::Actor<Events, Root, Context, Broker> actor(&arena);
+	SUCCEED();
+}
+
+TEST(AllocationTests, statesAreStoredInPlace){
+	CountingResource resource;
+	Context context;
+	Broker broker;
+	TestSM state_machine(std::allocator_arg, houdini::JAllocator<std::byte>(&resource), context, broker);
+
+	const auto* begin = reinterpret_cast<const std::byte*>(&state_machine);
+	const auto* end = begin + sizeof(state_machine);
+	const auto* state = reinterpret_cast<const std::byte*>(&std::get<S2>(state_machine.states));
+	EXPECT_TRUE(state >= begin && state < end);
+}
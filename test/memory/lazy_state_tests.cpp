@@ -0,0 +1,131 @@
+#include "houdini/houdini.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+enum LazyEvents : houdini::JEvent {
+	next,
+	back
+};
+
+JANUS_CREATE_EVENT(LazyEvents, event);
+
+struct LazyContext : houdini::act::BaseContext {
+	int entries = 0;
+	int exits = 0;
+};
+
+using LazyBroker = houdini::brokers::BaseBroker;
+
+inline int constructions = 0;
+
+struct Counted : houdini::State<LazyContext, LazyBroker> {
+	Counted() { constructions++; }
+
+	void onEntry(LazyContext& context, LazyBroker&) override {
+		context.entries++;
+		this->visits++;
+	}
+
+	int visits = 0;
+};
+
+struct First : Counted {};
+
+struct Transient : Counted {
+	static constexpr bool transient() { return true; }
+	char scratch[512];
+};
+
+struct Structural : houdini::State<LazyContext, LazyBroker> {};
+
+//only constructed to run its exit hook
+struct Closing : houdini::State<LazyContext, LazyBroker> {
+	static constexpr bool transient() { return true; }
+
+	void onExit(LazyContext& context, LazyBroker&) override {
+		context.exits++;
+	}
+};
+
+struct LazyRoot : houdini::State<LazyContext, LazyBroker> {
+	static constexpr bool lazy_states() { return true; }
+
+	static constexpr auto make_transition_table(){
+		//clang-format off
+		using namespace houdini;
+		return transition_table(
+			*state<First>      + event<next> = state<Transient>,
+			 state<Transient>  + event<next> = state<Structural>,
+			 state<Structural> + event<back> = state<Transient>,
+			 state<Structural> + event<next> = state<Closing>,
+			 state<Closing>    + event<next> = state<Structural>,
+			 state<Transient>  + event<back> = state<First>
+		);
+		//clang-format on
+	}
+};
+
+using LazySM = houdini::SM<LazyRoot, LazyEvents, LazyContext, LazyBroker>;
+
+} //namespace
+
+TEST(LazyStateTests, statesAreConstructedOnFirstEntry){
+	LazyContext context;
+	LazyBroker broker;
+	constructions = 0;
+	LazySM state_machine(context, broker);
+
+	static_assert(houdini::sm::is_lazy_states<LazySM::StateTuple>::value);
+	EXPECT_EQ(constructions, 0);
+	EXPECT_EQ(state_machine.materializedStates(), 0u);
+
+	state_machine.processEvent(next);
+	EXPECT_TRUE(state_machine.is(houdini::state<Transient>));
+	EXPECT_EQ(constructions, 1);
+	EXPECT_EQ(state_machine.materializedStates(), 1u);
+	EXPECT_EQ(state_machine.stateMemoryHighWaterMark(), sizeof(Transient));
+}
+
+TEST(LazyStateTests, transientStatesAreDestroyedOnExit){
+	LazyContext context;
+	LazyBroker broker;
+	constructions = 0;
+	LazySM state_machine(context, broker);
+
+	state_machine.processEvent(next);
+	state_machine.processEvent(next);
+	EXPECT_TRUE(state_machine.is(houdini::state<Structural>));
+	//structural states have nothing to call, so they are never constructed
+	EXPECT_EQ(state_machine.materializedStates(), 0u);
+
+	state_machine.processEvent(back);
+	state_machine.processEvent(back);
+	EXPECT_TRUE(state_machine.is(houdini::state<First>));
+	EXPECT_EQ(constructions, 3);
+	EXPECT_EQ(context.entries, 3);
+	EXPECT_EQ(state_machine.materializedStates(), 1u);
+
+	state_machine.processEvent(next);
+	EXPECT_EQ(state_machine.materializedStates(), 2u);
+	EXPECT_EQ(constructions, 4);
+	EXPECT_EQ(state_machine.stateMemoryHighWaterMark(), sizeof(First) + sizeof(Transient));
+}
+
+TEST(LazyStateTests, transientStatesWithOnlyAnExitHookAreDestroyedOnExit){
+	LazyContext context;
+	LazyBroker broker;
+	LazySM state_machine(context, broker);
+
+	state_machine.processEvent(next);
+	state_machine.processEvent(next);
+	state_machine.processEvent(next);
+	EXPECT_TRUE(state_machine.is(houdini::state<Closing>));
+	EXPECT_EQ(state_machine.materializedStates(), 0u);
+
+	state_machine.processEvent(next);
+	EXPECT_TRUE(state_machine.is(houdini::state<Structural>));
+	EXPECT_EQ(context.exits, 1);
+	EXPECT_EQ(state_machine.materializedStates(), 0u);
+}
@@ -0,0 +1,195 @@
+#include "allocation_audit.hpp"
+
+#include "houdini/houdini.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+
+/**
+ * These tests are built with JANUS_STATIC_QUEUES defined and check that, once constructed, 
+ * state machines and actors process events without a single heap allocation.
+ */
+static_assert(std::is_same_v<houdini::JQueue<int>, houdini::util::StaticQueue<int, JANUS_STATIC_QUEUE_CAPACITY>>,
+	"Steady state tests must be compiled with JANUS_STATIC_QUEUES");
+
+enum Events : houdini::JEvent {
+	e1,
+	e2,
+	e3,
+	ie1
+};
+
+JANUS_CREATE_EVENT(Events, event);
+
+struct Context : houdini::act::BaseContext {
+	int actions = 0;
+	int entries = 0;
+	int updates = 0;
+};
+
+using Broker = houdini::brokers::MessageBroker<Events>;
+
+struct EvenGuard {
+	bool operator()(houdini::JEvent, Context& context, Broker&) const {
+		return context.actions % 2 == 0;
+	}
+};
+
+struct CountAction {
+	void operator()(houdini::JEvent, Context& context, Broker&) const {
+		context.actions++;
+	}
+};
+
+struct Updating : houdini::State<Context, Broker> {
+	Updating() : houdini::State<Context, Broker>(1) {}
+
+	void onEntry(Context& context, Broker&) override {
+		context.entries++;
+	}
+
+	void update(Context& context, Broker&) override {
+		context.updates++;
+	}
+};
+
+struct Inner1 : houdini::State<Context, Broker> {};
+struct Inner2 : houdini::State<Context, Broker> {};
+
+struct Nested : houdini::State<Context, Broker> {
+	static constexpr auto make_transition_table(){
+		//clang-format off
+		using namespace houdini;
+		return transition_table(
+			*state<Inner1> + event<ie1> = state<Inner2>,
+			 state<Inner2> + event<ie1> = state<Inner1>
+		);
+		//clang-format on
+	}
+};
+
+struct Root : houdini::State<Context, Broker> {
+	static constexpr auto make_transition_table(){
+		//clang-format off
+		using namespace houdini;
+		return transition_table(
+			*state<Updating> + event<e1> [EvenGuard{}] / CountAction{} = state<Nested>,
+			 state<Updating> + event<e1> / CountAction{}                = state<Updating>,
+			 state<Nested>   + event<e2> / CountAction{}                = state<Updating>,
+			 state<Nested>   + event<e3>                                = state<Nested>
+		);
+		//clang-format on
+	}
+};
+
+TEST(AllocationAuditTests, auditCountsAllocations){
+	AllocationAudit audit;
+	auto p = std::make_unique<int>(1);
+	//volatile keeps the compiler from eliding the malloc/free pair
+	void* volatile q = std::malloc(16);
+	EXPECT_GE(audit.allocations(), 2u);
+	EXPECT_GE(audit.bytes(), sizeof(int) + 16);
+	std::free(q);
+}
+
+TEST(StaticQueueTests, queueRejectsEventsWhenFull){
+	Broker broker;
+	for (std::size_t i = 0; i < JANUS_STATIC_QUEUE_CAPACITY; i++){
+		ASSERT_TRUE(broker.queueEvent(e1));
+	}
+	EXPECT_FALSE(broker.queueEvent(e1));
+	EXPECT_EQ(broker.getNumEvents(), static_cast<std::size_t>(JANUS_STATIC_QUEUE_CAPACITY));
+	EXPECT_EQ(broker.getFirstEvent(), e1);
+	EXPECT_TRUE(broker.queueEvent(e2));
+}
+
+TEST(SteadyStateAllocationTests, stateMachineDoesNotAllocateAfterConstruction){
+	Context context;
+	Broker broker;
+	houdini::SM<Root, Events, Context, Broker> state_machine(context, broker);
+	const Events sequence[] = {e1, e1, ie1, ie1, e3, ie1, e2, e1, e2};
+
+	std::size_t allocations = 0;
+	{
+		AllocationAudit audit;
+		for (int i = 0; i < 1000; i++){
+			for (Events e: sequence){
+				state_machine.processEvent(e);
+			}
+			state_machine.update();
+		}
+		allocations = audit.allocations();
+	}
+	EXPECT_EQ(allocations, 0u);
+	EXPECT_GT(context.actions, 0);
+	EXPECT_GT(context.entries, 0);
+}
+
+/**
+ * Exposes the steps of `Actor::run` so they can be driven from the test thread.
+ */
+class AuditedActor : public houdini::act::Actor<Events, Root, Context, Broker> {
+	public:
+		bool post(Events event){
+			return this->message_broker.queueEvent(event);
+		}
+
+		void dispatchOnce(){
+			while (this->message_broker.hasEvents()){
+				this->processEvent(this->message_broker.getFirstEvent());
+			}
+			this->actor_sm.update();
+		}
+
+		const Context& context() const {
+			return this->execution_context;
+		}
+};
+
+TEST(SteadyStateAllocationTests, actorDoesNotAllocateAfterConstruction){
+	AuditedActor actor;
+	const Events sequence[] = {e1, e1, ie1, ie1, e3, ie1, e2, e1, e2};
+	
+	std::size_t allocations = 0;
+	{
+		AllocationAudit audit;
+		for (int i = 0; i < 1000; i++){
+			for (Events e: sequence){
+				actor.post(e);
+			}
+			actor.dispatchOnce();
+		}
+		allocations = audit.allocations();
+	}
+	EXPECT_EQ(allocations, 0u);
+	EXPECT_GT(actor.context().actions, 0);
+}
+
+TEST(StaticQueueTests, deferQueueRejectsEventsWhenFull){
+	houdini::sm::DeferQueue queue;
+	for (std::size_t i = 0; i < JANUS_STATIC_QUEUE_CAPACITY; i++){
+		ASSERT_TRUE(queue.push(houdini::EventBuffer(e1)));
+	}
+	EXPECT_FALSE(queue.push(houdini::EventBuffer(e2)));
+	EXPECT_EQ(queue.size(), static_cast<std::size_t>(JANUS_STATIC_QUEUE_CAPACITY));
+}
+
+TEST(StaticQueueTests, snapshotsWithMoreDeferredEventsThanFitAreRejected){
+	Context context;
+	Broker broker;
+	houdini::SM<Root, Events, Context, Broker> state_machine(context, broker);
+
+	//the deferred event count is stored last, followed by the events, here all e1
+	auto defer = [&state_machine](std::uint32_t count){
+		auto blob = state_machine.snapshot();
+		for (std::size_t i = 0; i < sizeof(count); i++){
+			blob[blob.size() - sizeof(count) + i] = static_cast<std::byte>((count >> (8 * i)) & 0xff);
+		}
+		blob.insert(blob.end(), count * sizeof(houdini::JEvent), std::byte{e1});
+		return blob;
+	};
+	EXPECT_FALSE(state_machine.restore(defer(JANUS_STATIC_QUEUE_CAPACITY + 1)));
+	EXPECT_TRUE(state_machine.restore(defer(JANUS_STATIC_QUEUE_CAPACITY)));
+}
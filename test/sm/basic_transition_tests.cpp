@@ -147,4 +147,24 @@ TEST_F(BasicTransitionTests, guardsAreFunctional){
     EXPECT_TRUE(state_machine.is(houdini::state<S4>)) << "Guard should never fail";
     EXPECT_EQ(state_machine.currentStateName(), "S4");
     
-}
\ No newline at end of file
+}
+
+TEST_F(BasicTransitionTests, transitionsWithoutGuardOrActionHaveNoDispatchEntry){
+    using ParentList = houdini::sm::detail::TypeList<houdini::sm::TState<Root>>;
+    auto state_map = houdini::sm::getCombinedStateTypeIDs(state_machine.root_state);
+    const auto s1 = houdini::sm::getCombinedStateIndex(state_map, ParentList{}, houdini::state<S1>);
+    const auto s3 = houdini::sm::getCombinedStateIndex(state_map, ParentList{}, houdini::state<S3>);
+
+    //S3 + e2 = S4 has neither guard nor action
+    ASSERT_EQ((*state_machine.dispatch_map)[e2][s3].size(), 1);
+    EXPECT_EQ((*state_machine.dispatch_map)[e2][s3].front().transition, nullptr);
+    //S1 + e4 [TrueGuard] = S4 is guarded
+    ASSERT_EQ((*state_machine.dispatch_map)[e4][s1].size(), 1);
+    EXPECT_NE((*state_machine.dispatch_map)[e4][s1].front().transition, nullptr);
+
+    state_machine.processEvent(e1);
+    state_machine.processEvent(e2);
+    EXPECT_TRUE(state_machine.is(houdini::state<IS31>, houdini::state<S3>));
+    EXPECT_EQ(state_machine.processEvent(e2), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<S4>));
+}
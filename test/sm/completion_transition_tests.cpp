@@ -0,0 +1,117 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+enum KilnEvents : houdini::JEvent {
+    fire,
+    shutdown
+};
+
+JANUS_CREATE_EVENT(KilnEvents, kiln);
+
+struct KilnContext : houdini::act::BaseContext {
+    std::string hooks;
+    bool cooled = false;
+};
+
+using KilnBroker = houdini::brokers::BaseBroker;
+
+//records its entry and exit in the context
+template <char Name>
+struct LoggedState : houdini::State<KilnContext, KilnBroker> {
+    void onEntry(KilnContext& context, KilnBroker&) override {
+        context.hooks += '+';
+        context.hooks += Name;
+    }
+
+    void onExit(KilnContext& context, KilnBroker&) override {
+        context.hooks += '-';
+        context.hooks += Name;
+    }
+};
+
+struct Cooled {
+    bool operator()(houdini::JEvent, KilnContext& context, KilnBroker&) const {
+        return context.cooled;
+    }
+};
+
+struct KilnOff : LoggedState<'O'> {};
+struct Preheat : houdini::State<KilnContext, KilnBroker> {};
+struct Ramp : houdini::State<KilnContext, KilnBroker> {};
+struct Soak : LoggedState<'S'> {};
+struct Firing : LoggedState<'F'> {};
+struct Cooling : LoggedState<'C'> {};
+
+struct KilnRoot : houdini::State<KilnContext, KilnBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<KilnOff> + kiln<fire>        = state<Preheat>,
+             state<Preheat>                     = state<Ramp>,
+             state<Ramp>                        = state<Soak>,
+             state<Soak>                        = state<Firing>,
+             state<Firing>  + kiln<shutdown>    = state<Cooling>,
+             state<Cooling> [Cooled{}]          = state<KilnOff>
+        );
+        //clang-format on
+    }
+};
+
+using KilnSM = houdini::SM<KilnRoot, KilnEvents, KilnContext, KilnBroker>;
+
+class CompletionTransitionTests : public ::testing::Test {
+    protected:
+        houdini::sm::StateIndex indexOf(std::string_view name){
+            KilnSM probe{context, broker};
+            for (houdini::sm::StateIndex index = 0; index < KilnSM::NUM_STATES; index++){
+                probe.activate(index);
+                if (probe.currentStateName() == name){
+                    return index;
+                }
+            }
+            return KilnSM::NUM_STATES;
+        }
+
+        KilnContext context;
+        KilnBroker broker;
+        KilnSM state_machine{context, broker};
+};
+
+TEST_F(CompletionTransitionTests, onlyStatesWithAnonymousTransitionsAreLookedUp){
+    EXPECT_FALSE(KilnSM::completion_states[indexOf("KilnOff")]);
+    EXPECT_FALSE(KilnSM::completion_states[indexOf("Firing")]);
+    EXPECT_TRUE(KilnSM::completion_states[indexOf("Preheat")]);
+    EXPECT_TRUE(KilnSM::completion_states[indexOf("Cooling")]);
+}
+
+TEST_F(CompletionTransitionTests, chainsStopAtStatesWithHooks){
+    //Ramp has no hooks, so it is skipped over, but the hooks of Soak have to run
+    EXPECT_EQ(KilnSM::completion_targets[indexOf("Preheat")], indexOf("Soak"));
+    EXPECT_EQ(KilnSM::completion_targets[indexOf("Ramp")], indexOf("Soak"));
+    EXPECT_EQ(KilnSM::completion_targets[indexOf("Soak")], indexOf("Firing"));
+    //guarded transitions are dispatched as usual
+    EXPECT_EQ(KilnSM::completion_targets[indexOf("Cooling")], KilnSM::NUM_STATES);
+    EXPECT_EQ(KilnSM::completion_targets[indexOf("KilnOff")], KilnSM::NUM_STATES);
+}
+
+TEST_F(CompletionTransitionTests, chainsRunTheHooksOfEachStateInOrder){
+    using namespace houdini;
+    state_machine.processEvent(fire);
+    EXPECT_TRUE(state_machine.is(state<Firing>));
+    EXPECT_EQ(context.hooks, "-O+S-S+F");
+
+    context.hooks.clear();
+    state_machine.processEvent(shutdown);
+    EXPECT_TRUE(state_machine.is(state<Cooling>));
+    context.cooled = true;
+    state_machine.processEvent(shutdown);
+    EXPECT_TRUE(state_machine.is(state<Cooling>)) << "Anonymous transitions are only tried after a transition";
+    EXPECT_EQ(context.hooks, "-F+C");
+}
@@ -0,0 +1,107 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+enum PlanEvents : houdini::JEvent {
+    pick,
+    place,
+    retry,
+    drop
+};
+
+JANUS_CREATE_EVENT(PlanEvents, plan);
+
+struct Waiting : houdini::State<> {};
+
+struct Gripping : houdini::State<> {
+    void onEntry(houdini::act::BaseContext&, houdini::brokers::BaseBroker&) override {
+        attempts++;
+    }
+
+    int attempts = 0;
+};
+
+struct Placing : houdini::State<> {};
+
+struct Arm : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Gripping> + plan<place> = state<Placing>,
+             state<Placing>  + plan<retry> = state<Gripping>
+        );
+        //clang-format on
+    }
+};
+
+struct PlanRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Waiting> + plan<pick>  = state<Arm>,
+             state<Arm>     + plan<drop>  = state<Waiting>
+        );
+        //clang-format on
+    }
+};
+
+using PlanSM = houdini::SM<PlanRoot, PlanEvents>;
+
+class CopyTests : public ::testing::Test {
+    protected:
+        houdini::act::BaseContext context;
+        houdini::brokers::BaseBroker broker;
+        PlanSM state_machine{context, broker};
+};
+
+TEST_F(CopyTests, copiesShareTheDispatchTable){
+    PlanSM copy(state_machine);
+    EXPECT_EQ(copy.dispatch_map.get(), state_machine.dispatch_map.get());
+    EXPECT_EQ(state_machine.dispatch_map.use_count(), 2);
+}
+
+TEST_F(CopyTests, copiesRunIndependently){
+    using namespace houdini;
+    state_machine.processEvent(pick);
+    ASSERT_TRUE(state_machine.is(state<Gripping>, state<Arm>));
+
+    PlanSM fork(state_machine);
+    EXPECT_TRUE(fork.is(state<Gripping>, state<Arm>));
+    EXPECT_EQ(fork.processEvent(place), SMResult::SUCCESS);
+    EXPECT_EQ(fork.processEvent(retry), SMResult::SUCCESS);
+    EXPECT_EQ(std::get<Gripping>(fork.states).attempts, 2);
+    EXPECT_EQ(fork.processEvent(drop), SMResult::SUCCESS);
+    EXPECT_TRUE(fork.is(state<Waiting>));
+
+    EXPECT_TRUE(state_machine.is(state<Gripping>, state<Arm>)) << "Events processed by a copy should not change the original";
+    EXPECT_EQ(std::get<Gripping>(state_machine.states).attempts, 1);
+    EXPECT_EQ(state_machine.processEvent(place), SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(state<Placing>, state<Arm>));
+}
+
+TEST_F(CopyTests, discardedCopiesReleaseTheDispatchTable){
+    using namespace houdini;
+    for (int i = 0; i < 1000; i++){
+        PlanSM fork(state_machine);
+        fork.processEvent(pick);
+        fork.processEvent(place);
+        ASSERT_TRUE(fork.is(state<Placing>, state<Arm>));
+    }
+    EXPECT_EQ(state_machine.dispatch_map.use_count(), 1);
+    EXPECT_TRUE(state_machine.is(state<Waiting>));
+}
+
+TEST_F(CopyTests, dependenciesAreNotSetOnASharedDispatchTable){
+    using namespace houdini;
+    {
+        PlanSM copy(state_machine);
+        EXPECT_FALSE(state_machine.setDependency());
+        EXPECT_FALSE(copy.setDependency());
+    }
+    EXPECT_TRUE(state_machine.setDependency());
+    EXPECT_EQ(state_machine.processEvent(pick), SMResult::SUCCESS);
+}
@@ -0,0 +1,166 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+enum BoilerEvents : houdini::JEvent {
+    ignite,
+    modulate,
+    trip
+};
+
+JANUS_CREATE_EVENT(BoilerEvents, boiler);
+
+struct BoilerContext : houdini::act::BaseContext {
+    int severity = 0;
+    bool vented = true;
+    std::size_t entries = 0;
+    std::size_t exits = 0;
+    std::size_t guards = 0;
+    std::size_t actions = 0;
+};
+
+using BoilerBroker = houdini::brokers::BaseBroker;
+
+//counts the hooks run by each state
+template <int Id>
+struct BoilerState : houdini::State<BoilerContext, BoilerBroker> {
+    void onEntry(BoilerContext& context, BoilerBroker&) override {
+        context.entries++;
+    }
+
+    void onExit(BoilerContext& context, BoilerBroker&) override {
+        context.exits++;
+    }
+};
+
+struct Severe {
+    bool operator()(houdini::JEvent, BoilerContext& context, BoilerBroker&) const {
+        context.guards++;
+        return context.severity > 2;
+    }
+};
+
+struct Minor {
+    bool operator()(houdini::JEvent, BoilerContext& context, BoilerBroker&) const {
+        context.guards++;
+        return context.severity > 0;
+    }
+};
+
+struct Vented {
+    bool operator()(houdini::JEvent, BoilerContext& context, BoilerBroker&) const {
+        context.guards++;
+        return context.vented;
+    }
+};
+
+struct LogTrip {
+    void operator()(houdini::JEvent, BoilerContext& context, BoilerBroker&) const {
+        context.actions++;
+    }
+};
+
+struct Cold : BoilerState<0> {};
+struct Low : BoilerState<1> {};
+struct High : BoilerState<2> {};
+struct Purging : BoilerState<3> {};
+struct Venting : BoilerState<4> {};
+
+struct Lit : BoilerState<5> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Low>  + boiler<modulate> = state<High>,
+             state<High> + boiler<modulate> = state<Low>
+        );
+        //clang-format on
+    }
+};
+
+struct BoilerRoot : houdini::State<BoilerContext, BoilerBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Cold>    + boiler<ignite>                        = state<Lit>,
+             state<Lit>     + boiler<trip> [Severe{}]               = state<Cold>,
+             state<Lit>     + boiler<trip> [Minor{}] / LogTrip{}    = state<Purging>,
+             state<Purging>                                         = state<Venting>,
+             state<Venting> [Vented{}]                              = state<Cold>
+        );
+        //clang-format on
+    }
+};
+
+using BoilerSM = houdini::SM<BoilerRoot, BoilerEvents, BoilerContext, BoilerBroker>;
+
+class ExecutionBoundTests : public ::testing::Test {
+    protected:
+        BoilerContext context;
+        BoilerBroker broker;
+        BoilerSM state_machine{context, broker};
+};
+
+TEST_F(ExecutionBoundTests, boundsIncludeTheAnonymousTransitionChain){
+    constexpr houdini::sm::ExecutionBounds bounds = BoilerSM::execution_bounds;
+    EXPECT_TRUE(bounds.bounded);
+    EXPECT_EQ(bounds.anonymous_chain, 2);
+    //leaving Low and Lit, then Purging and Venting
+    EXPECT_EQ(bounds.exits, 4);
+    //entering Lit and Low, then Venting and Cold
+    EXPECT_EQ(bounds.entries, 4);
+    //both trip guards, then the guard of Venting on each step of the chain and once more at its end
+    EXPECT_EQ(bounds.guards, 5);
+    EXPECT_EQ(bounds.actions, 1);
+    EXPECT_EQ(bounds.worst_event, trip);
+}
+
+TEST_F(ExecutionBoundTests, worstCaseEventStaysWithinTheBounds){
+    using namespace houdini;
+    constexpr sm::ExecutionBounds bounds = BoilerSM::execution_bounds;
+    state_machine.activate(bounds.worst_state);
+    EXPECT_TRUE(state_machine.is(state<Low>, state<Lit>) || state_machine.is(state<High>, state<Lit>));
+    EXPECT_EQ(context.entries, 0) << "Activating a state should not run its hooks";
+
+    context.severity = 1;
+    state_machine.processEvent(static_cast<BoilerEvents>(bounds.worst_event));
+    EXPECT_TRUE(state_machine.is(state<Cold>));
+    EXPECT_EQ(context.exits, bounds.exits);
+    EXPECT_LE(context.entries, bounds.entries);
+    EXPECT_LE(context.guards, bounds.guards);
+    EXPECT_EQ(context.actions, bounds.actions);
+}
+
+TEST_F(ExecutionBoundTests, guardedAnonymousTransitionsWaitForTheirGuard){
+    using namespace houdini;
+    context.vented = false;
+    state_machine.processEvent(ignite);
+    context.severity = 1;
+    state_machine.processEvent(trip);
+    EXPECT_TRUE(state_machine.is(state<Venting>));
+}
+
+TEST(ExecutionBoundCycleTests, anonymousCyclesAreUnbounded){
+    using houdini::sm::TransitionFootprint;
+    constexpr houdini::JEvent none = 3;
+    //a root state with two child states
+    constexpr std::array<houdini::sm::StateIndex, 3> parents = {3, 0, 0};
+    constexpr std::array<std::size_t, 3> depths = {1, 2, 2};
+    constexpr std::array<TransitionFootprint, 3> cycle = {
+        TransitionFootprint{0, 1, 2, false, false, false, false},
+        TransitionFootprint{none, 1, 2, false, false, true, false},
+        TransitionFootprint{none, 2, 1, false, false, true, false}};
+    static_assert(!houdini::sm::compute_execution_bounds(parents, depths, cycle, none, 2).bounded);
+
+    constexpr std::array<TransitionFootprint, 2> chain = {cycle[0], cycle[1]};
+    constexpr houdini::sm::ExecutionBounds bounds = houdini::sm::compute_execution_bounds(parents, depths, chain, none, 2);
+    EXPECT_TRUE(bounds.bounded);
+    EXPECT_EQ(bounds.anonymous_chain, 1);
+    EXPECT_EQ(bounds.worst_state, 1);
+    EXPECT_EQ(bounds.worst_event, 0);
+}
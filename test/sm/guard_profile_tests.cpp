@@ -0,0 +1,157 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+enum RouteEvents : houdini::JEvent {
+    route,
+    back
+};
+
+JANUS_CREATE_EVENT(RouteEvents, revent);
+
+struct RouteContext : houdini::act::BaseContext {
+    int destination = 0;
+    int guard_evaluations = 0;
+};
+
+using RouteBroker = houdini::brokers::BaseBroker;
+using RouteState = houdini::State<RouteContext, RouteBroker>;
+
+template <int Destination>
+struct RouteIs {
+    template <typename Broker>
+    bool operator()(houdini::JEvent, RouteContext& context, Broker&) const {
+        context.guard_evaluations++;
+        return context.destination == Destination;
+    }
+};
+
+struct Idle : RouteState {};
+struct Link0 : RouteState {};
+struct Link1 : RouteState {};
+struct Link2 : RouteState {};
+
+constexpr auto makeRoutingTable(){
+    //clang-format off
+    using namespace houdini;
+    return transition_table(
+        *state<Idle>  + revent<route>[RouteIs<0>{}] = state<Link0>,
+         state<Idle>  + revent<route>[RouteIs<1>{}] = state<Link1>,
+         state<Idle>  + revent<route>[RouteIs<2>{}] = state<Link2>,
+         state<Link0> + revent<back> = state<Idle>,
+         state<Link1> + revent<back> = state<Idle>,
+         state<Link2> + revent<back> = state<Idle>
+    );
+    //clang-format on
+}
+
+struct Router : RouteState {
+    static constexpr auto make_transition_table(){
+        return makeRoutingTable();
+    }
+};
+
+struct ProfiledRouter : RouteState {
+    static constexpr auto make_transition_table(){
+        return makeRoutingTable();
+    }
+};
+
+//Idle is the first state after the root state
+JANUS_GUARD_PROFILE(ProfiledRouter,
+    houdini::sm::GuardHits{route, 1, 0, 0},
+    houdini::sm::GuardHits{route, 1, 1, 1},
+    houdini::sm::GuardHits{route, 1, 2, 10});
+
+template <class SM>
+void routeTo(SM& state_machine, RouteContext& context, int destination){
+    context.destination = destination;
+    state_machine.processEvent(route);
+    state_machine.processEvent(back);
+}
+
+TEST(GuardProfileTests, guardHitsAreCounted){
+    RouteContext context;
+    RouteBroker broker;
+    houdini::SM<Router, RouteEvents, RouteContext, RouteBroker> state_machine(context, broker);
+
+    for (int i = 0; i < 10; i++){
+        routeTo(state_machine, context, 2);
+    }
+    routeTo(state_machine, context, 1);
+
+    auto hits = state_machine.guardHits();
+    ASSERT_EQ(hits.size(), 3);
+    for (std::size_t i = 0; i < hits.size(); i++){
+        EXPECT_EQ(hits[i].event, route);
+        EXPECT_EQ(hits[i].state, 1);
+        EXPECT_EQ(hits[i].position, i);
+    }
+    EXPECT_EQ(hits[0].hits, 0);
+    EXPECT_EQ(hits[1].hits, 1);
+    EXPECT_EQ(hits[2].hits, 10);
+}
+
+TEST(GuardProfileTests, profileIsWrittenAsHeader){
+    RouteContext context;
+    RouteBroker broker;
+    houdini::SM<Router, RouteEvents, RouteContext, RouteBroker> state_machine(context, broker);
+    routeTo(state_machine, context, 2);
+
+    std::ostringstream os;
+    state_machine.writeGuardProfile(os);
+    const std::string header = os.str();
+
+    EXPECT_NE(header.find("#pragma once"), std::string::npos);
+    EXPECT_NE(header.find("JANUS_GUARD_PROFILE(Router"), std::string::npos);
+    EXPECT_NE(header.find("houdini::sm::GuardHits{0, 1, 2, 1}"), std::string::npos);
+}
+
+TEST(GuardProfileTests, mostFrequentGuardIsEvaluatedFirst){
+    RouteContext context;
+    RouteBroker broker;
+    houdini::SM<ProfiledRouter, RouteEvents, RouteContext, RouteBroker> state_machine(context, broker);
+
+    context.destination = 2;
+    EXPECT_EQ(state_machine.processEvent(route), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<Link2>));
+    EXPECT_EQ(context.guard_evaluations, 1);
+    state_machine.processEvent(back);
+
+    context.guard_evaluations = 0;
+    context.destination = 0;
+    EXPECT_EQ(state_machine.processEvent(route), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<Link0>));
+    EXPECT_EQ(context.guard_evaluations, 3);
+
+    //hits are still reported against the declared positions
+    auto hits = state_machine.guardHits();
+    ASSERT_EQ(hits.size(), 3);
+    EXPECT_EQ(hits[0].position, 2);
+    EXPECT_EQ(hits[0].hits, 1);
+}
+
+TEST(GuardProfileTests, copiesCountTheirOwnHits){
+    RouteContext context;
+    RouteBroker broker;
+    houdini::SM<Router, RouteEvents, RouteContext, RouteBroker> state_machine(context, broker);
+    routeTo(state_machine, context, 2);
+
+    //the copy shares the dispatch table, but not the hit counts
+    auto copy = state_machine;
+    EXPECT_EQ(copy.guardHits()[2].hits, 0);
+    routeTo(copy, context, 1);
+    routeTo(copy, context, 1);
+
+    auto hits = state_machine.guardHits();
+    EXPECT_EQ(hits[1].hits, 0);
+    EXPECT_EQ(hits[2].hits, 1);
+    auto copy_hits = copy.guardHits();
+    EXPECT_EQ(copy_hits[1].hits, 2);
+    EXPECT_EQ(copy_hits[2].hits, 0);
+}
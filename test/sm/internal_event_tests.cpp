@@ -0,0 +1,113 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+enum StepEvents : houdini::JEvent {
+    start,
+    step,
+    finish,
+    measure,
+    flood
+};
+
+JANUS_CREATE_EVENT(StepEvents, event);
+
+struct Measurement {
+    int value;
+};
+
+JANUS_EVENT_PAYLOAD(StepEvents, measure, Measurement);
+
+struct StepContext : houdini::act::BaseContext {
+    std::vector<int> trace;
+    int posted = 0;
+    int rejected = 0;
+};
+
+using StepBroker = houdini::brokers::BaseBroker;
+
+struct PostStep {
+    void operator()(houdini::JEvent, StepContext& context, StepBroker&, houdini::InternalEventQueue& internal_events) const {
+        context.trace.push_back(1);
+        internal_events.post(step);
+    }
+};
+
+struct PostFinishAndMeasure {
+    void operator()(houdini::JEvent, StepContext& context, StepBroker&, houdini::InternalEventQueue& internal_events) const {
+        context.trace.push_back(2);
+        internal_events.post(finish);
+        internal_events.post(measure, Measurement{42});
+    }
+};
+
+struct RecordFinish {
+    void operator()(houdini::JEvent, StepContext& context, StepBroker&) const {
+        context.trace.push_back(3);
+    }
+};
+
+struct RecordMeasurement {
+    void operator()(houdini::JEvent, const Measurement& measurement, StepContext& context, StepBroker&) const {
+        context.trace.push_back(measurement.value);
+    }
+};
+
+struct Flood {
+    void operator()(houdini::JEvent, StepContext& context, StepBroker&, houdini::InternalEventQueue& internal_events) const {
+        for (int i = 0; i < JANUS_INTERNAL_EVENT_QUEUE_CAPACITY + 1; i++){
+            if (internal_events.post(finish)){
+                context.posted++;
+            } else {
+                context.rejected++;
+            }
+        }
+    }
+};
+
+struct Ready : houdini::State<StepContext, StepBroker> {};
+struct Working : houdini::State<StepContext, StepBroker> {};
+struct Done : houdini::State<StepContext, StepBroker> {};
+
+struct StepRoot : houdini::State<StepContext, StepBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Ready>   + event<start> / PostStep{}             = state<Working>,
+             state<Working> + event<step> / PostFinishAndMeasure{}  = state<Working>,
+             state<Working> + event<finish> / RecordFinish{}        = state<Done>,
+             state<Done>    + event<measure> / RecordMeasurement{}  = state<Done>,
+             state<Ready>   + event<flood> / Flood{}                = state<Ready>,
+             state<Ready>   + event<finish> / RecordFinish{}        = state<Ready>
+        );
+        //clang-format on
+    }
+};
+
+class InternalEventTests : public ::testing::Test {
+    protected:
+        StepContext context;
+        StepBroker broker;
+        houdini::SM<StepRoot, StepEvents, StepContext, StepBroker> state_machine{context, broker};
+};
+
+TEST_F(InternalEventTests, postedEventsAreProcessedBeforeReturning){
+    EXPECT_EQ(state_machine.processEvent(start), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<Done>));
+    EXPECT_TRUE(state_machine.internal_events.empty());
+    EXPECT_EQ(context.trace, (std::vector<int>{1, 2, 3, 42}));
+}
+
+TEST_F(InternalEventTests, fullQueueRejectsEvents){
+    state_machine.processEvent(flood);
+    EXPECT_EQ(context.posted, JANUS_INTERNAL_EVENT_QUEUE_CAPACITY);
+    EXPECT_EQ(context.rejected, 1);
+    //every accepted event is processed
+    EXPECT_EQ(context.trace.size(), static_cast<std::size_t>(JANUS_INTERNAL_EVENT_QUEUE_CAPACITY));
+    EXPECT_TRUE(state_machine.internal_events.empty());
+}
@@ -0,0 +1,232 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/sm/backend/event_journal.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+#include "houdini/util/timing_wheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum ValveEvents : houdini::JEvent {
+    valve_open,
+    valve_close,
+    valve_set
+};
+
+JANUS_CREATE_EVENT(ValveEvents, valve);
+
+struct Aperture {
+    double fraction;
+};
+
+JANUS_EVENT_PAYLOAD(ValveEvents, valve_set, Aperture);
+
+struct ValveContext : houdini::act::BaseContext {
+    double aperture = 0;
+};
+
+using ValveBroker = houdini::brokers::BaseBroker;
+
+struct SetAperture {
+    void operator()(houdini::JEvent, const Aperture& payload, ValveContext& context, ValveBroker&) const {
+        context.aperture = payload.fraction;
+    }
+};
+
+struct Shut : houdini::State<ValveContext, ValveBroker> {};
+struct Flowing : houdini::State<ValveContext, ValveBroker> {};
+
+struct ValveRoot : houdini::State<ValveContext, ValveBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Shut>    + valve<valve_open>                    = state<Flowing>,
+             state<Flowing> + valve<valve_close>                   = state<Shut>,
+             state<Flowing> + valve<valve_set> / SetAperture{}     = state<Flowing>
+        );
+        //clang-format on
+    }
+};
+
+using ValveSM = houdini::SM<ValveRoot, ValveEvents, ValveContext, ValveBroker>;
+
+struct Draining : houdini::State<ValveContext, ValveBroker> {};
+
+struct TimedValveRoot : houdini::State<ValveContext, ValveBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Shut>     + valve<valve_open>  = state<Flowing>,
+             state<Flowing>  + after<100>         = state<Draining>,
+             state<Draining> + valve<valve_close> = state<Shut>
+        );
+        //clang-format on
+    }
+};
+
+using TimedValveSM = houdini::SM<TimedValveRoot, ValveEvents, ValveContext, ValveBroker>;
+
+class JournalTests : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            this->path = ::testing::TempDir() + "journal_tests_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+            this->removeFiles();
+        }
+
+        void TearDown() override {
+            this->removeFiles();
+        }
+
+        void removeFiles(){
+            std::remove(this->path.c_str());
+            std::remove((this->path + ".checkpoint").c_str());
+        }
+
+        std::string path;
+        ValveBroker broker;
+};
+
+TEST_F(JournalTests, onlyCommittedRecordsAreVisible){
+    houdini::sm::JournalOptions options;
+    options.commit_bytes = 1 << 20;
+    options.commit_interval = std::chrono::hours(1);
+    houdini::sm::EventJournal journal(path, ValveSM::LAYOUT_HASH, options);
+    ASSERT_TRUE(journal.good());
+
+    EXPECT_TRUE(journal.append(valve_open, nullptr, 0));
+    const Aperture aperture{0.5};
+    EXPECT_TRUE(journal.append(valve_set, &aperture, sizeof(aperture)));
+
+    //a second mapping of the file sees what would survive a crash
+    houdini::sm::EventJournal reader(path, ValveSM::LAYOUT_HASH, options);
+    std::size_t records = 0;
+    reader.forEach([&](std::uint64_t, houdini::JEvent, const std::byte*, std::size_t){ records++; });
+    EXPECT_EQ(records, 0);
+
+    journal.commit();
+    std::vector<std::uint64_t> sequences;
+    reader.forEach([&](std::uint64_t sequence, houdini::JEvent event, const std::byte* payload, std::size_t size){
+        sequences.push_back(sequence);
+        if (event == valve_set){
+            ASSERT_EQ(size, sizeof(Aperture));
+            Aperture read{};
+            std::memcpy(&read, payload, size);
+            EXPECT_EQ(read.fraction, 0.5);
+        }
+    });
+    EXPECT_EQ(sequences, (std::vector<std::uint64_t>{1, 2}));
+}
+
+TEST_F(JournalTests, groupCommitsBySize){
+    houdini::sm::JournalOptions options;
+    options.commit_bytes = 4 * sizeof(houdini::sm::JournalRecord);
+    options.commit_interval = std::chrono::hours(1);
+    houdini::sm::EventJournal journal(path, ValveSM::LAYOUT_HASH, options);
+    houdini::sm::EventJournal reader(path, ValveSM::LAYOUT_HASH, options);
+
+    auto committed = [&reader](){
+        std::size_t records = 0;
+        reader.forEach([&](std::uint64_t, houdini::JEvent, const std::byte*, std::size_t){ records++; });
+        return records;
+    };
+    for (int i = 0; i < 3; i++){
+        journal.append(valve_open, nullptr, 0);
+    }
+    EXPECT_EQ(committed(), 0);
+    journal.append(valve_open, nullptr, 0);
+    EXPECT_EQ(committed(), 4);
+}
+
+TEST_F(JournalTests, recoversFromCheckpointAndJournal){
+    using namespace houdini;
+    {
+        ValveContext context;
+        ValveSM state_machine(context, broker);
+        sm::EventJournal journal(path, ValveSM::LAYOUT_HASH);
+        sm::JournaledSM<ValveSM> journaled(state_machine, journal, 3);
+        ASSERT_EQ(journaled.recover(), std::size_t{0});
+
+        journaled.processEvent(valve_open);
+        journaled.processEvent(valve_set, Aperture{0.25});
+        journaled.processEvent(valve_close);
+        //checkpoint, then journaled after it
+        journaled.processEvent(valve_open);
+        journaled.processEvent(valve_set, Aperture{0.75});
+        ASSERT_TRUE(state_machine.is(state<Flowing>));
+    }
+
+    ValveContext context;
+    ValveSM state_machine(context, broker);
+    sm::EventJournal journal(path, ValveSM::LAYOUT_HASH);
+    sm::JournaledSM<ValveSM> journaled(state_machine, journal, 3);
+    EXPECT_EQ(journaled.recover(), std::size_t{2});
+    EXPECT_TRUE(state_machine.is(state<Flowing>));
+    EXPECT_EQ(context.aperture, 0.75);
+
+    //sequence numbers continue after the recovered events
+    EXPECT_EQ(journal.nextSequence(), 6);
+    journaled.processEvent(valve_close);
+    EXPECT_TRUE(state_machine.is(state<Shut>));
+}
+
+TEST_F(JournalTests, rejectsJournalsOfOtherStateMachines){
+    {
+        houdini::sm::EventJournal journal(path, ValveSM::LAYOUT_HASH);
+        ASSERT_TRUE(journal.good());
+    }
+    houdini::sm::EventJournal journal(path, ValveSM::LAYOUT_HASH + 1);
+    EXPECT_FALSE(journal.good());
+    EXPECT_FALSE(journal.append(valve_open, nullptr, 0));
+}
+
+TEST_F(JournalTests, eventsThatCannotBeJournaledAreNotProcessed){
+    using namespace houdini;
+    {
+        sm::EventJournal journal(path, ValveSM::LAYOUT_HASH);
+        std::vector<std::byte> payload(std::size_t{1} << 16);
+        EXPECT_FALSE(journal.append(valve_set, payload.data(), payload.size()));
+        EXPECT_EQ(journal.size(), 0);
+    }
+
+    sm::EventJournal journal(path, ValveSM::LAYOUT_HASH + 1);
+    ASSERT_FALSE(journal.good());
+    ValveContext context;
+    ValveSM state_machine(context, broker);
+    sm::JournaledSM<ValveSM> journaled(state_machine, journal);
+    EXPECT_EQ(journaled.processEvent(valve_open), SMResult::ERROR);
+    EXPECT_TRUE(state_machine.is(state<Shut>));
+}
+
+TEST_F(JournalTests, recoversTimeTriggeredTransitions){
+    using namespace houdini;
+    {
+        ValveContext context;
+        util::TimingWheel wheel;
+        TimedValveSM state_machine(context, broker);
+        state_machine.attachTimers(wheel);
+        wheel.advance(TimePoint{});
+        sm::EventJournal journal(path, TimedValveSM::LAYOUT_HASH);
+        sm::JournaledSM<TimedValveSM> journaled(state_machine, journal);
+
+        journaled.processEvent(valve_open);
+        wheel.advance(TimePoint{} + std::chrono::milliseconds(150));
+        ASSERT_TRUE(state_machine.is(state<Draining>));
+        journaled.commit();
+        state_machine.detachTimers();
+    }
+
+    //replayed without a timing wheel
+    ValveContext context;
+    TimedValveSM state_machine(context, broker);
+    sm::EventJournal journal(path, TimedValveSM::LAYOUT_HASH);
+    sm::JournaledSM<TimedValveSM> journaled(state_machine, journal);
+    EXPECT_EQ(journaled.recover(), std::size_t{2});
+    EXPECT_TRUE(state_machine.is(state<Draining>));
+    EXPECT_EQ(journal.nextSequence(), 3);
+}
@@ -0,0 +1,94 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+enum MetricEvents : houdini::JEvent {
+    start,
+    stop
+};
+
+JANUS_CREATE_EVENT(MetricEvents, mevent);
+
+struct Stopped : houdini::State<> {};
+
+struct Running : houdini::State<> {
+    void onEntry(houdini::act::BaseContext&, houdini::brokers::BaseBroker&) override {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+};
+
+struct MetricsRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Stopped> + mevent<start> = state<Running>,
+             state<Running> + mevent<stop>  = state<Stopped>
+        );
+        //clang-format on
+    }
+};
+
+using MetricsSM = houdini::SM<MetricsRoot, MetricEvents>;
+
+class MetricsTests : public ::testing::Test {
+    protected:
+        houdini::act::BaseContext context;
+        houdini::brokers::BaseBroker broker;
+        MetricsSM state_machine{context, broker};
+
+        static constexpr auto stopped = MetricsSM::indexOf(houdini::state<Stopped>);
+        static constexpr auto running = MetricsSM::indexOf(houdini::state<Running>);
+};
+
+TEST_F(MetricsTests, transitionLatenciesAreRecordedPerCell){
+    for (int i = 0; i < 5; i++){
+        state_machine.processEvent(start);
+        state_machine.processEvent(stop);
+    }
+    state_machine.processEvent(stop); //not handled in Stopped
+
+    auto start_latency = state_machine.transitionLatency(stopped, start);
+    EXPECT_EQ(start_latency.count, 5);
+    //the entry hook of Running sleeps
+    EXPECT_GE(start_latency.percentile(99), 150000.0);
+    EXPECT_EQ(state_machine.transitionLatency(running, stop).count, 5);
+    EXPECT_EQ(state_machine.transitionLatency(stopped, stop).count, 0);
+    EXPECT_EQ(state_machine.transitionLatency(running, start).count, 0);
+}
+
+TEST_F(MetricsTests, stateHooksAndDwellTimesAreRecorded){
+    state_machine.processEvent(start);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    state_machine.processEvent(stop);
+
+    EXPECT_EQ(state_machine.entryLatency(running).count, 1);
+    EXPECT_GE(state_machine.entryLatency(running).max(), 150000.0);
+    //Stopped has no hooks
+    EXPECT_EQ(state_machine.entryLatency(stopped).count, 0);
+    EXPECT_EQ(state_machine.exitLatency(stopped).count, 0);
+
+    EXPECT_EQ(state_machine.dwellTime(stopped).count, 1);
+    EXPECT_EQ(state_machine.dwellTime(running).count, 1);
+    EXPECT_GE(state_machine.dwellTime(running).max(), 1.5e6);
+}
+
+TEST_F(MetricsTests, snapshotsCanBeTakenFromAnotherThread){
+    std::thread reader([this](){
+        for (int i = 0; i < 100; i++){
+            auto snapshot = state_machine.transitionLatency(stopped, start);
+            EXPECT_LE(snapshot.count, 20);
+        }
+    });
+    for (int i = 0; i < 20; i++){
+        state_machine.processEvent(start);
+        state_machine.processEvent(stop);
+    }
+    reader.join();
+    EXPECT_EQ(state_machine.transitionLatency(stopped, start).count, 20);
+}
@@ -0,0 +1,128 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+enum PayloadEvents : houdini::JEvent {
+    setpoint,
+    reset,
+    plain
+};
+
+JANUS_CREATE_EVENT(PayloadEvents, event);
+
+struct Setpoint {
+    double value;
+    int source;
+};
+
+JANUS_EVENT_PAYLOAD(PayloadEvents, setpoint, Setpoint);
+
+struct PayloadContext : houdini::act::BaseContext {
+    double value = 0;
+    int source = -1;
+    const Setpoint* guard_address = nullptr;
+    const Setpoint* action_address = nullptr;
+    int plain_actions = 0;
+};
+
+using PayloadBroker = houdini::brokers::BaseBroker;
+
+struct PositiveSetpoint {
+    bool operator()(houdini::JEvent, const Setpoint& payload, PayloadContext& context, PayloadBroker&) const {
+        context.guard_address = &payload;
+        return payload.value > 0;
+    }
+};
+
+struct ApplySetpoint {
+    void operator()(houdini::JEvent, const Setpoint& payload, PayloadContext& context, PayloadBroker&) const {
+        context.action_address = &payload;
+        context.value = payload.value;
+        context.source = payload.source;
+    }
+};
+
+//actions that do not take the payload can still be attached to events that carry one
+struct CountPlain {
+    void operator()(houdini::JEvent, PayloadContext& context, PayloadBroker&) const {
+        context.plain_actions++;
+    }
+};
+
+struct Idle : houdini::State<PayloadContext, PayloadBroker> {};
+struct Tracking : houdini::State<PayloadContext, PayloadBroker> {};
+
+struct PayloadRoot : houdini::State<PayloadContext, PayloadBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Idle>     + event<setpoint> [PositiveSetpoint{}] / ApplySetpoint{} = state<Tracking>,
+             state<Tracking> + event<setpoint> / CountPlain{}                         = state<Tracking>,
+             state<Tracking> + event<reset>                                           = state<Idle>,
+             state<Idle>     + event<plain> / CountPlain{}                            = state<Idle>
+        );
+        //clang-format on
+    }
+};
+
+class PayloadTests : public ::testing::Test {
+    protected:
+        PayloadContext context;
+        PayloadBroker broker;
+        houdini::SM<PayloadRoot, PayloadEvents, PayloadContext, PayloadBroker> state_machine{context, broker};
+};
+
+TEST_F(PayloadTests, payloadIsPassedByReferenceToGuardAndAction){
+    const Setpoint target{2.5, 7};
+    EXPECT_EQ(state_machine.processEvent(setpoint, target), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<Tracking>));
+    EXPECT_EQ(context.value, 2.5);
+    EXPECT_EQ(context.source, 7);
+    EXPECT_EQ(context.guard_address, &target);
+    EXPECT_EQ(context.action_address, &target);
+}
+
+TEST_F(PayloadTests, guardsCanRejectPayload){
+    EXPECT_EQ(state_machine.processEvent(setpoint, Setpoint{-1.0, 1}), houdini::SMResult::FAILED);
+    EXPECT_TRUE(state_machine.is(houdini::state<Idle>));
+    EXPECT_EQ(context.action_address, nullptr);
+}
+
+TEST_F(PayloadTests, callablesWithoutPayloadParameterAreSupported){
+    state_machine.processEvent(setpoint, Setpoint{1.0, 1});
+    state_machine.processEvent(setpoint, Setpoint{3.0, 2});
+    EXPECT_EQ(context.plain_actions, 1);
+    EXPECT_EQ(context.value, 1.0);
+
+    state_machine.processEvent(reset);
+    state_machine.processEvent(plain);
+    EXPECT_EQ(context.plain_actions, 2);
+}
+
+TEST_F(PayloadTests, eventBufferStoresPayloadInPlace){
+    static_assert(sizeof(houdini::EventBuffer) <= JANUS_MAX_EVENT_PAYLOAD_SIZE + 2*alignof(std::max_align_t));
+    houdini::EventBuffer buffer(setpoint, Setpoint{4.0, 3});
+    houdini::EventBuffer no_payload(plain);
+
+    EXPECT_EQ(buffer.id(), static_cast<houdini::JEvent>(setpoint));
+    EXPECT_NE(buffer.payload(), nullptr);
+    EXPECT_EQ(no_payload.payload(), nullptr);
+
+    EXPECT_EQ(state_machine.processEvent(buffer), houdini::SMResult::SUCCESS);
+    EXPECT_EQ(context.value, 4.0);
+    EXPECT_EQ(context.source, 3);
+    EXPECT_EQ(context.action_address, buffer.payload());
+}
+
+TEST_F(PayloadTests, eventsWithoutTheirDeclaredPayloadAreRejected){
+    EXPECT_EQ(state_machine.processEvent(setpoint), houdini::SMResult::ERROR);
+    EXPECT_EQ(state_machine.processEvent(houdini::EventBuffer(setpoint)), houdini::SMResult::ERROR);
+    EXPECT_EQ(state_machine.processEvent(plain, Setpoint{1.0, 1}), houdini::SMResult::ERROR);
+    EXPECT_EQ(state_machine.processEvent(setpoint, 1.0), houdini::SMResult::ERROR);
+    EXPECT_TRUE(state_machine.is(houdini::state<Idle>));
+    EXPECT_EQ(context.guard_address, nullptr);
+    EXPECT_EQ(context.plain_actions, 0);
+}
@@ -0,0 +1,80 @@
+#include "basic_sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+#include "houdini/util/perf_counters.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+class PerfCounterTests : public ::testing::Test {
+    protected:
+        houdini::act::BaseContext context;
+        houdini::brokers::BaseBroker broker;
+        houdini::SM<Root, Events> state_machine{context, broker};
+
+        void SetUp() override {
+            if (!state_machine.perfCountersAvailable()){
+                GTEST_SKIP() << "Hardware performance counters are not available on this machine.";
+            }
+        }
+};
+
+TEST(PerfCounterGroupTests, readsFailWhenUnavailable){
+    houdini::util::PerfCounterGroup group;
+    houdini::util::PerfSample sample;
+    sample.cycles = 42;
+    EXPECT_EQ(group.read(sample), group.available());
+    if (!group.available()){
+        EXPECT_EQ(sample.cycles, 42);
+    }
+}
+
+TEST(PerfCounterGroupTests, scopesAddDifferences){
+    houdini::util::PerfCounterGroup group;
+    houdini::util::PerfTotals totals;
+    {
+        houdini::util::PerfScope scope(group, totals);
+        volatile int sink = 0;
+        for (int i = 0; i < 1000; i++){
+            sink = sink + i;
+        }
+    }
+    auto snapshot = totals.snapshot();
+    if (group.available()){
+        EXPECT_EQ(snapshot.samples, 1);
+        EXPECT_GT(snapshot.totals.instructions, 1000);
+    } else {
+        EXPECT_EQ(snapshot.samples, 0);
+    }
+}
+
+TEST_F(PerfCounterTests, countersAreAttributedToDispatchedCells){
+    using SM = houdini::SM<Root, Events>;
+    constexpr auto s1 = SM::indexOf(houdini::state<S1>);
+    constexpr auto s4 = SM::indexOf(houdini::state<S4>);
+
+    state_machine.processEvent(e4); //S1 -> S4
+    state_machine.processEvent(e4); //S4 -> S4
+    state_machine.processEvent(e4);
+
+    auto from_s1 = state_machine.dispatchCounters(s1, e4);
+    auto from_s4 = state_machine.dispatchCounters(s4, e4);
+    EXPECT_EQ(from_s1.samples, 1);
+    EXPECT_EQ(from_s4.samples, 2);
+    EXPECT_GT(from_s4.totals.instructions, 0);
+    EXPECT_GT(from_s4.ipc(), 0.0);
+    EXPECT_EQ(state_machine.dispatchCounters(s1, e1).samples, 0);
+}
+
+TEST_F(PerfCounterTests, countersFollowTheDispatchingThread){
+    using SM = houdini::SM<Root, Events>;
+    constexpr auto s1 = SM::indexOf(houdini::state<S1>);
+
+    //the state machine was constructed on this thread, and dispatches on another
+    std::thread([this](){ state_machine.processEvent(e4); }).join();
+
+    auto from_s1 = state_machine.dispatchCounters(s1, e4);
+    EXPECT_EQ(from_s1.samples, 1);
+    EXPECT_GT(from_s1.totals.instructions, 0);
+}
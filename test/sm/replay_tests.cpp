@@ -0,0 +1,156 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/sm/backend/event_replay.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+enum PumpEvents : houdini::JEvent {
+    prime,
+    pump,
+    vent
+};
+
+JANUS_CREATE_EVENT(PumpEvents, pevent);
+
+struct Stroke {
+    int volume;
+};
+
+JANUS_EVENT_PAYLOAD(PumpEvents, pump, Stroke);
+
+struct PumpContext : houdini::act::BaseContext {
+    int pumped = 0;
+};
+
+using PumpBroker = houdini::brokers::BaseBroker;
+
+struct AddStroke {
+    void operator()(houdini::JEvent, const Stroke& payload, PumpContext& context, PumpBroker&) const {
+        context.pumped += payload.volume;
+    }
+};
+
+struct Dry : houdini::State<PumpContext, PumpBroker> {};
+struct Primed : houdini::State<PumpContext, PumpBroker> {};
+
+struct PumpRoot : houdini::State<PumpContext, PumpBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Dry>    + pevent<prime>                 = state<Primed>,
+             state<Primed> + pevent<pump> / AddStroke{}    = state<Primed>,
+             state<Primed> + pevent<vent>                  = state<Dry>
+        );
+        //clang-format on
+    }
+};
+
+using PumpSM = houdini::SM<PumpRoot, PumpEvents, PumpContext, PumpBroker>;
+
+class ReplayTests : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            this->path = ::testing::TempDir() + "replay_tests_" + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+            std::remove(this->path.c_str());
+
+            //record 100 cycles of prime, 3 strokes of 1 to 3 and vent
+            houdini::sm::EventJournal journal(this->path, PumpSM::LAYOUT_HASH);
+            for (int i = 0; i < 100; i++){
+                journal.append(prime, nullptr, 0);
+                for (int volume = 1; volume <= 3; volume++){
+                    const Stroke stroke{volume};
+                    journal.append(pump, &stroke, sizeof(stroke));
+                }
+                journal.append(vent, nullptr, 0);
+            }
+        }
+
+        void TearDown() override {
+            std::remove(this->path.c_str());
+        }
+
+        std::string path;
+        PumpBroker broker;
+};
+
+TEST_F(ReplayTests, replaysAllRecordedEvents){
+    houdini::sm::ReplayStream stream(path, PumpSM::LAYOUT_HASH);
+    ASSERT_TRUE(stream.good());
+
+    PumpContext context;
+    PumpSM state_machine(context, broker);
+    const auto stats = houdini::sm::replay(state_machine, stream);
+    EXPECT_EQ(stats.events, 500);
+    EXPECT_EQ(stats.invalid_events, 0);
+    EXPECT_EQ(context.pumped, 600);
+    EXPECT_TRUE(state_machine.is(houdini::state<Dry>));
+}
+
+TEST_F(ReplayTests, checksConfigurationsAgainstRecordedTrace){
+    houdini::sm::ReplayStream stream(path, PumpSM::LAYOUT_HASH);
+    houdini::sm::ConfigurationTrace trace;
+    {
+        PumpContext context;
+        PumpSM state_machine(context, broker);
+        houdini::sm::replay(state_machine, stream, trace.recorder());
+    }
+    ASSERT_EQ(trace.configurations.size(), 500);
+    const std::string trace_path = path + ".trace";
+    ASSERT_TRUE(trace.save(trace_path));
+
+    houdini::sm::ConfigurationTrace expected;
+    ASSERT_TRUE(expected.load(trace_path));
+    std::remove(trace_path.c_str());
+    EXPECT_EQ(expected.configurations, trace.configurations);
+
+    PumpContext context;
+    PumpSM state_machine(context, broker);
+    houdini::sm::replay(state_machine, stream, expected.checker());
+    EXPECT_EQ(expected.mismatches, 0);
+    EXPECT_TRUE(expected.complete());
+
+    //a replay that stops before the end of the trace
+    expected.configurations.push_back(expected.configurations.back());
+    PumpSM truncated(context, broker);
+    houdini::sm::replay(truncated, stream, expected.checker());
+    EXPECT_EQ(expected.mismatches, 0);
+    EXPECT_FALSE(expected.complete());
+    expected.configurations.pop_back();
+
+    //the 7th event (sequence 7) is the first stroke of the second cycle
+    expected.configurations[6] = static_cast<std::uint16_t>(PumpSM::indexOf(houdini::state<Dry>));
+    PumpSM diverging(context, broker);
+    houdini::sm::replay(diverging, stream, expected.checker());
+    EXPECT_EQ(expected.mismatches, 1);
+    EXPECT_EQ(expected.first_mismatch, 7);
+    EXPECT_FALSE(expected.complete());
+}
+
+TEST_F(ReplayTests, replaysStreamsInParallel){
+    houdini::sm::ReplayStream stream(path, PumpSM::LAYOUT_HASH);
+    std::vector<int> pumped(8);
+    const auto stats = houdini::sm::replayInParallel(pumped.size(), 4, [&](std::size_t i){
+        PumpContext context;
+        PumpBroker job_broker;
+        PumpSM state_machine(context, job_broker);
+        auto result = houdini::sm::replay(state_machine, stream);
+        pumped[i] = context.pumped;
+        return result;
+    });
+    EXPECT_EQ(stats.threads, 4);
+    EXPECT_EQ(stats.events(), 8 * 500);
+    EXPECT_GT(stats.eventsPerSecondPerThread(), 0.0);
+    EXPECT_EQ(pumped, std::vector<int>(8, 600));
+}
+
+TEST_F(ReplayTests, rejectsStreamsOfOtherStateMachines){
+    houdini::sm::ReplayStream stream(path, PumpSM::LAYOUT_HASH + 1);
+    EXPECT_FALSE(stream.good());
+    houdini::sm::ReplayStream missing(path + ".missing", PumpSM::LAYOUT_HASH);
+    EXPECT_FALSE(missing.good());
+}
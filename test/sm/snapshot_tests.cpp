@@ -0,0 +1,167 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+
+#include <gtest/gtest.h>
+
+enum SnapshotEvents : houdini::JEvent {
+    connect_session,
+    end_session,
+    advance,
+    resume
+};
+
+JANUS_CREATE_EVENT(SnapshotEvents, sevent);
+
+static int entries = 0;
+
+struct Parked : houdini::State<> {};
+struct Handshake : houdini::State<> {};
+
+struct Streaming : houdini::State<> {
+    void onEntry(houdini::act::BaseContext&, houdini::brokers::BaseBroker&) override {
+        entries++;
+    }
+};
+
+struct Session : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Handshake> + sevent<advance> = state<Streaming>
+        );
+        //clang-format on
+    }
+};
+
+struct SnapshotRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Parked>    + sevent<connect_session> = state<Session>,
+             state<Session> + sevent<end_session>     = state<Parked>,
+             state<Parked>    + sevent<resume>          = history<Session>
+        );
+        //clang-format on
+    }
+};
+
+struct RelayRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Parked> + sevent<connect_session> = state<Handshake>
+        );
+        //clang-format on
+    }
+};
+
+using SnapshotSM = houdini::SM<SnapshotRoot, SnapshotEvents>;
+
+class SnapshotTests : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            entries = 0;
+        }
+
+        houdini::act::BaseContext context;
+        houdini::brokers::BaseBroker broker;
+        SnapshotSM state_machine{context, broker};
+};
+
+TEST_F(SnapshotTests, restoresActiveStatesWithoutRunningHooks){
+    using namespace houdini;
+    state_machine.processEvent(connect_session);
+    state_machine.processEvent(advance);
+    ASSERT_TRUE(state_machine.is(state<Streaming>, state<Session>));
+    ASSERT_EQ(entries, 1);
+
+    auto blob = state_machine.snapshot();
+    SnapshotSM restored{context, broker};
+    ASSERT_TRUE(restored.restore(blob));
+    EXPECT_TRUE(restored.is(state<Streaming>, state<Session>));
+    EXPECT_EQ(restored.currentStateName(), "Streaming");
+    EXPECT_EQ(entries, 1) << "Restoring should not run entry hooks";
+
+    EXPECT_EQ(restored.processEvent(end_session), SMResult::SUCCESS);
+    EXPECT_TRUE(restored.is(state<Parked>));
+}
+
+TEST_F(SnapshotTests, restoresHistory){
+    using namespace houdini;
+    state_machine.processEvent(connect_session);
+    state_machine.processEvent(advance);
+    state_machine.processEvent(end_session);
+
+    SnapshotSM restored{context, broker};
+    ASSERT_TRUE(restored.restore(state_machine.snapshot()));
+    EXPECT_TRUE(restored.is(state<Parked>));
+    restored.processEvent(resume);
+    EXPECT_TRUE(restored.is(state<Streaming>, state<Session>));
+}
+
+TEST_F(SnapshotTests, rejectsSnapshotsOfOtherStateMachines){
+    using namespace houdini;
+    static_assert(SnapshotSM::LAYOUT_HASH != SM<RelayRoot, SnapshotEvents>::LAYOUT_HASH);
+
+    SM<RelayRoot, SnapshotEvents> other{context, broker};
+    other.processEvent(connect_session);
+    EXPECT_FALSE(state_machine.restore(other.snapshot()));
+    EXPECT_TRUE(state_machine.is(state<Parked>));
+}
+
+TEST_F(SnapshotTests, rejectsMalformedSnapshots){
+    using namespace houdini;
+    state_machine.processEvent(connect_session);
+    const auto blob = state_machine.snapshot();
+    state_machine.processEvent(end_session);
+
+    //truncated at every length
+    for (std::size_t size = 0; size < blob.size(); size++){
+        EXPECT_FALSE(state_machine.restore(blob.data(), size)) << "size " << size;
+    }
+
+    //trailing data
+    auto extended = blob;
+    extended.push_back(std::byte{0});
+    EXPECT_FALSE(state_machine.restore(extended));
+
+    //out of range state index, stored right after the header and the active state count
+    auto corrupted = blob;
+    corrupted[16] = std::byte{0xff};
+    EXPECT_FALSE(state_machine.restore(corrupted));
+
+    //state indices in range, but not a path from the root state
+    auto detached = blob;
+    detached[20] = static_cast<std::byte>(SnapshotSM::indexOf(houdini::state<Parked>));
+    EXPECT_FALSE(state_machine.restore(detached));
+    auto rootless = blob;
+    rootless[16] = rootless[18];
+    EXPECT_FALSE(state_machine.restore(rootless));
+
+    //a path from the root state that stops at Session, a parent state, with none of its children active
+    auto truncated = blob;
+    truncated[14] = std::byte{2};
+    truncated.erase(truncated.begin() + 20, truncated.begin() + 22);
+    EXPECT_FALSE(state_machine.restore(truncated));
+
+    auto wrong_version = blob;
+    wrong_version[4] = std::byte{2};
+    EXPECT_FALSE(state_machine.restore(wrong_version));
+
+    EXPECT_TRUE(state_machine.is(state<Parked>)) << "A rejected snapshot should leave the state machine unchanged";
+    EXPECT_TRUE(state_machine.restore(blob));
+    EXPECT_TRUE(state_machine.is(state<Handshake>, state<Session>));
+
+    //a deferred event that is not an event of the enum
+    auto deferred = blob;
+    deferred[deferred.size() - 4] = std::byte{1};
+    deferred.push_back(static_cast<std::byte>(SnapshotSM::NO_EVENT_VALUE));
+    deferred.push_back(std::byte{0});
+    EXPECT_FALSE(state_machine.restore(deferred));
+    deferred[deferred.size() - 2] = static_cast<std::byte>(resume);
+    EXPECT_TRUE(state_machine.restore(deferred));
+}
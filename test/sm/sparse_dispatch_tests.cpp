@@ -0,0 +1,59 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+#include "basic_sm.hpp"
+
+#include <gtest/gtest.h>
+
+//protocol identifiers: few events with large values
+enum ProtocolEvents : houdini::JEvent {
+    connect = 3,
+    heartbeat = 120,
+    disconnect = 250
+};
+
+JANUS_CREATE_EVENT(ProtocolEvents, pevent);
+
+struct Disconnected : houdini::State<> {};
+struct Connected : houdini::State<> {};
+
+struct ProtocolRoot : houdini::State<> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Disconnected> + pevent<connect>    = state<Connected>,
+             state<Connected>    + pevent<heartbeat>  = state<Connected>,
+             state<Connected>    + pevent<disconnect> = state<Disconnected>
+        );
+        //clang-format on
+    }
+};
+
+using ProtocolSM = houdini::SM<ProtocolRoot, ProtocolEvents>;
+
+TEST(SparseDispatchTests, sparseLayoutIsSelectedForSparseEnums){
+    static_assert(ProtocolSM::SPARSE_DISPATCH);
+    //three events in use, plus the shared empty row
+    static_assert(ProtocolSM::event_slots.rows == 4);
+    static_assert(ProtocolSM::DISPATCH_BYTES_SAVED > 0);
+    static_assert(ProtocolSM::DISPATCH_BYTES_SAVED == ProtocolSM::DENSE_DISPATCH_BYTES - ProtocolSM::SPARSE_DISPATCH_BYTES);
+
+    static_assert(!houdini::SM<Root, Events>::SPARSE_DISPATCH);
+    static_assert(houdini::SM<Root, Events>::DISPATCH_BYTES_SAVED == 0);
+}
+
+TEST(SparseDispatchTests, sparseLayoutDispatchesEvents){
+    houdini::act::BaseContext context;
+    houdini::brokers::BaseBroker broker;
+    ProtocolSM state_machine(context, broker);
+
+    EXPECT_EQ(state_machine.processEvent(heartbeat), houdini::SMResult::NOTHING);
+    EXPECT_EQ(state_machine.processEvent(connect), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<Connected>));
+    EXPECT_EQ(state_machine.processEvent(connect), houdini::SMResult::NOTHING);
+    EXPECT_EQ(state_machine.processEvent(heartbeat), houdini::SMResult::SUCCESS);
+    EXPECT_EQ(state_machine.processEvent(disconnect), houdini::SMResult::SUCCESS);
+    EXPECT_TRUE(state_machine.is(houdini::state<Disconnected>));
+    EXPECT_EQ(state_machine.processEvent(static_cast<ProtocolEvents>(200)), houdini::SMResult::NOTHING);
+}
@@ -0,0 +1,154 @@
+#include "houdini/sm/sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+#include "houdini/util/timing_wheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+enum HeaterEvents : houdini::JEvent {
+    warm,
+    cool
+};
+
+JANUS_CREATE_EVENT(HeaterEvents, heater);
+
+struct HeaterContext : houdini::act::BaseContext {
+    int samples = 0;
+    int temperature = 20;
+};
+
+using HeaterBroker = houdini::brokers::BaseBroker;
+
+struct Sample {
+    void operator()(houdini::JEvent, HeaterContext& context, HeaterBroker&) const {
+        context.samples++;
+    }
+};
+
+struct Overheated {
+    bool operator()(houdini::JEvent, HeaterContext& context, HeaterBroker&) const {
+        return context.temperature > 90;
+    }
+};
+
+struct Standby : houdini::State<HeaterContext, HeaterBroker> {};
+struct Heating : houdini::State<HeaterContext, HeaterBroker> {};
+struct Holding : houdini::State<HeaterContext, HeaterBroker> {};
+
+struct HeaterRoot : houdini::State<HeaterContext, HeaterBroker> {
+    static constexpr auto make_transition_table(){
+        //clang-format off
+        using namespace houdini;
+        return transition_table(
+            *state<Standby> + heater<warm>                  = state<Heating>,
+             state<Heating> + after<200>                    = state<Holding>,
+             state<Heating> + heater<cool>                  = state<Standby>,
+             state<Holding> + every<100> / Sample{}         = state<Holding>,
+             state<Holding> + after<1000>[Overheated{}]     = state<Standby>,
+             state<Holding> + heater<cool>                  = state<Standby>
+        );
+        //clang-format on
+    }
+};
+
+using HeaterSM = houdini::SM<HeaterRoot, HeaterEvents, HeaterContext, HeaterBroker>;
+
+class TimerTests : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            state_machine.attachTimers(wheel);
+            wheel.advance(start);
+        }
+
+        void advanceTo(std::chrono::milliseconds time){
+            wheel.advance(start + time);
+        }
+
+        HeaterContext context;
+        HeaterBroker broker;
+        houdini::TimePoint start{};
+        houdini::util::TimingWheel wheel;
+        HeaterSM state_machine{context, broker};
+};
+
+TEST_F(TimerTests, timersHaveTheirOwnDispatchEvents){
+    EXPECT_EQ(HeaterSM::NUM_TIMERS, 3);
+    EXPECT_EQ(HeaterSM::DISPATCH_EVENTS, HeaterSM::NO_EVENT_VALUE + 1 + 3);
+    EXPECT_EQ(HeaterSM::timer_specs[0].duration_ms, 200u);
+    EXPECT_FALSE(HeaterSM::timer_specs[0].periodic);
+    EXPECT_TRUE(HeaterSM::timer_specs[1].periodic);
+}
+
+TEST_F(TimerTests, transitionIsTakenOnceTheDelayHasElapsed){
+    using namespace houdini;
+    EXPECT_TRUE(wheel.empty());
+    state_machine.processEvent(warm);
+    EXPECT_EQ(wheel.size(), 1);
+
+    advanceTo(199ms);
+    EXPECT_TRUE(state_machine.is(state<Heating>));
+    advanceTo(200ms);
+    EXPECT_TRUE(state_machine.is(state<Holding>));
+    //the periodic and guarded timers of the new state
+    EXPECT_EQ(wheel.size(), 2);
+}
+
+TEST_F(TimerTests, exitingTheSourceStateCancelsItsTimers){
+    using namespace houdini;
+    state_machine.processEvent(warm);
+    advanceTo(150ms);
+    state_machine.processEvent(cool);
+    EXPECT_TRUE(wheel.empty());
+
+    advanceTo(1s);
+    EXPECT_TRUE(state_machine.is(state<Standby>));
+}
+
+TEST_F(TimerTests, periodicTimersFireWhileTheStateIsActive){
+    using namespace houdini;
+    state_machine.processEvent(warm);
+    advanceTo(200ms);
+    ASSERT_TRUE(state_machine.is(state<Holding>));
+
+    advanceTo(550ms);
+    EXPECT_EQ(context.samples, 3);
+    //the guard of the 1s timer fails, so the state is kept and sampling carries on
+    advanceTo(1250ms);
+    EXPECT_TRUE(state_machine.is(state<Holding>));
+    EXPECT_EQ(context.samples, 10);
+
+    state_machine.processEvent(cool);
+    advanceTo(2s);
+    EXPECT_EQ(context.samples, 10);
+}
+
+TEST_F(TimerTests, guardedTimersTransitionWhenTheGuardPasses){
+    using namespace houdini;
+    context.temperature = 95;
+    state_machine.processEvent(warm);
+    advanceTo(1199ms);
+    EXPECT_TRUE(state_machine.is(state<Holding>));
+    advanceTo(1200ms);
+    EXPECT_TRUE(state_machine.is(state<Standby>));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerTests, restoredStatesArmTheirTimers){
+    using namespace houdini;
+    state_machine.processEvent(warm);
+    const auto blob = state_machine.snapshot();
+    state_machine.processEvent(cool);
+    ASSERT_TRUE(wheel.empty());
+
+    ASSERT_TRUE(state_machine.restore(blob));
+    EXPECT_EQ(wheel.size(), 1);
+    advanceTo(200ms);
+    EXPECT_TRUE(state_machine.is(state<Holding>));
+
+    HeaterSM copy(state_machine);
+    EXPECT_EQ(copy.timing_wheel, nullptr) << "Copies should not share the timers of the original";
+}
@@ -0,0 +1,132 @@
+#include "basic_sm.hpp"
+#include "houdini/actor/context.hpp"
+#include "houdini/brokers/message_broker.hpp"
+#include "houdini/sm/backend/trace_drainer.hpp"
+#include "houdini/util/spsc_ring.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+class TracingTests : public ::testing::Test {
+    protected:
+        houdini::act::BaseContext context;
+        houdini::brokers::BaseBroker broker;
+        houdini::SM<Root, Events> state_machine{context, broker};
+
+        std::size_t countOf(const std::string& text, const std::string& pattern){
+            std::size_t count = 0;
+            for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)){
+                count++;
+            }
+            return count;
+        }
+};
+
+TEST(SpscRingTests, preservesOrderAndRejectsWhenFull){
+    houdini::util::SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; i++){
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(ring.size(), 4);
+
+    int value = -1;
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.push(4));
+    for (int expected = 1; expected <= 4; expected++){
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(SpscRingTests, transfersBetweenThreads){
+    houdini::util::SpscRing<int, 64> ring;
+    constexpr int count = 10000;
+
+    std::thread producer([&ring](){
+        for (int i = 0; i < count; i++){
+            while (!ring.push(i)){}
+        }
+    });
+
+    int expected = 0;
+    int value;
+    while (expected < count){
+        if (ring.pop(value)){
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+    }
+    producer.join();
+}
+
+TEST_F(TracingTests, transitionsAreRecorded){
+    houdini::sm::TransitionRecord record;
+    auto& ring = state_machine.traceRing();
+    const auto from = state_machine.currentState();
+
+    state_machine.processEvent(e4); //S1 -> S4, guarded
+    ASSERT_EQ(ring.size(), 1);
+    ASSERT_TRUE(ring.pop(record));
+    EXPECT_EQ(record.event, e4);
+    EXPECT_EQ(record.from, from);
+    EXPECT_EQ(record.to, state_machine.currentState());
+    EXPECT_EQ(record.guards_evaluated, 1);
+    EXPECT_GT(record.timestamp, 0);
+
+    //rejected events are not recorded
+    state_machine.processEvent(e1);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(state_machine.droppedTraceRecords(), 0);
+}
+
+TEST_F(TracingTests, onlyGuardsThatRunAreCounted){
+    houdini::sm::TransitionRecord record;
+    auto& ring = state_machine.traceRing();
+
+    state_machine.processEvent(e1); //S1 -> S2, guarded
+    state_machine.processEvent(e2); //S2 -> S3, without guard
+    ASSERT_EQ(ring.size(), 2);
+    ASSERT_TRUE(ring.pop(record));
+    EXPECT_EQ(record.guards_evaluated, 1);
+    ASSERT_TRUE(ring.pop(record));
+    EXPECT_EQ(record.event, e2);
+    EXPECT_EQ(record.guards_evaluated, 0);
+}
+
+TEST_F(TracingTests, drainerWritesChromeTrace){
+    const std::string path = ::testing::TempDir() + "houdini_trace.bin";
+    {
+        houdini::sm::TraceDrainer drainer(path, std::chrono::milliseconds(1));
+        drainer.attach(state_machine.traceRing());
+        drainer.start();
+        state_machine.processEvent(e1); //S1 -> S2
+        state_machine.processEvent(e2); //S2 -> S3
+        state_machine.processEvent(e2); //S3 -> S4
+        drainer.stop();
+        EXPECT_TRUE(drainer.good());
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream json;
+    ASSERT_TRUE(houdini::sm::convertTraceToChromeJson(file, json));
+    const std::string trace = json.str();
+
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+    EXPECT_EQ(countOf(trace, "\"ph\":\"X\""), 9);
+    EXPECT_EQ(countOf(trace, "\"name\":\"action\""), 3);
+    std::remove(path.c_str());
+}
+
+TEST(TraceConversionTests, rejectsOtherFiles){
+    std::istringstream in("not a trace file");
+    std::ostringstream out;
+    EXPECT_FALSE(houdini::sm::convertTraceToChromeJson(in, out));
+}
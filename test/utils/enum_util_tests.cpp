@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <string_view>
 #include <array>
+#include <limits>
 
 class EnumUtilTests : public ::testing::Test {
 	protected:
@@ -43,6 +44,42 @@ class EnumUtilTests : public ::testing::Test {
 
 };
 
+enum class WideEnum : houdini::JEvent {
+	w0,
+	w1 = 300,
+	w2 = 1000
+};
+
+template <> struct houdini::util::enum_range<WideEnum> {
+	static constexpr int max = 1000;
+};
+
+enum class CountedEnum : houdini::JEvent {
+	c0,
+	c1,
+	c2
+};
+
+template <> struct houdini::util::enum_range<CountedEnum> {
+	static constexpr std::size_t count = 3;
+};
+
+//values on both sides of the boundaries between the chunks of values reflected together
+enum ChunkEdgeEnum : houdini::JEvent {
+	e63 = 63,
+	e64,
+	e127 = 127,
+	e128,
+	e257 = 257
+};
+
+template <int N> struct EnumHolder {
+	enum Nested {
+		n0,
+		n1
+	};
+};
+
 using namespace houdini;
 TEST_F(EnumUtilTests, enumMaxValueIsCorrect){	
 	EXPECT_EQ(util::enum_max_value<TestEnum>(), 4);
@@ -134,4 +171,60 @@ TEST_F(EnumUtilTests, invalidStrToEnumReturnsEmptyValue){
 	std::string_view val_string = "foo";
 	auto enum_value = util::enum_from_str<TestEnum>(val_string);
 	EXPECT_FALSE(enum_value.has_value());
-}
\ No newline at end of file
+}
+
+TEST_F(EnumUtilTests, strToEnumFindsEveryNameAndOnlyThem){
+	static_assert(util::enum_from_str<ScopedEnum>("s1") == ScopedEnum::s1);
+	for (TestEnum2 value:util::enum_values<TestEnum2>()){
+		EXPECT_EQ(util::enum_from_str<TestEnum2>(util::enum_name(value)), value);
+	}
+	for (ChunkEdgeEnum value:util::enum_values<ChunkEdgeEnum>()){
+		EXPECT_EQ(util::enum_from_str<ChunkEdgeEnum>(util::enum_name(value)), value);
+	}
+	for (std::string_view name:{"", "t", "t00", "T1", "t1 ", "e6", "e1280"}){
+		EXPECT_FALSE(util::enum_from_str<TestEnum2>(name).has_value()) << name;
+		EXPECT_FALSE(util::enum_from_str<ChunkEdgeEnum>(name).has_value()) << name;
+	}
+}
+
+TEST(EnumNameHashTests, valuesWithoutNameAreLeftOutOfTheHash){
+	using houdini::util::_enum::make_name_hash_table;
+	constexpr std::array<std::string_view, 5> names = {"", "g1", "", "g3", ""};
+	constexpr auto table = make_name_hash_table(names);
+	EXPECT_EQ(table.slots[table.slot("g1")], 1);
+	EXPECT_EQ(table.slots[table.slot("g3")], 3);
+	EXPECT_FALSE(names[table.slots[table.slot("")]].empty());
+}
+
+TEST_F(EnumUtilTests, valuesWithoutNameHaveAnEmptyName){
+	//below the smallest value, between values and above the largest value
+	EXPECT_EQ(util::enum_name(static_cast<TestEnum2>(9)), "");
+	EXPECT_EQ(util::enum_name(static_cast<TestEnum2>(100)), "");
+	EXPECT_EQ(util::enum_name(static_cast<ScopedEnum>(31)), "");
+	EXPECT_EQ(util::enum_name(static_cast<ScopedEnum>(std::numeric_limits<houdini::JEvent>::max())), "");
+}
+
+TEST(EnumRangeTests, customRangesReflectValuesBeyondTheDefaultMaximum){
+	EXPECT_EQ(util::enum_max_value<WideEnum>(), 1000);
+	EXPECT_EQ(util::enum_count<WideEnum>(), 3);
+	EXPECT_EQ(util::enum_name(WideEnum::w1), "w1");
+	EXPECT_EQ(util::enum_name(WideEnum::w2), "w2");
+	EXPECT_FALSE(util::enum_value_valid(static_cast<WideEnum>(999)));
+}
+
+TEST(EnumRangeTests, declaredCountsAreUsedAsIs){
+	static_assert(util::enum_max_value<CountedEnum>() == 2);
+	EXPECT_EQ(util::enum_values<CountedEnum>(), (std::array<CountedEnum, 3>{CountedEnum::c0, CountedEnum::c1, CountedEnum::c2}));
+	EXPECT_EQ(util::enum_names<CountedEnum>(), (std::array<std::string_view, 3>{"c0", "c1", "c2"}));
+}
+
+TEST(EnumRangeTests, valuesAroundChunkBoundariesAreReflected){
+	EXPECT_EQ(util::enum_values<ChunkEdgeEnum>(), (std::array<ChunkEdgeEnum, 5>{e63, e64, e127, e128, e257}));
+	EXPECT_EQ(util::enum_names<ChunkEdgeEnum>(), (std::array<std::string_view, 5>{"e63", "e64", "e127", "e128", "e257"}));
+	EXPECT_EQ(util::enum_name(e128), "e128");
+}
+
+TEST(EnumRangeTests, namesOfEnumsInClassTemplatesAreReflected){
+	using Nested = EnumHolder<2>::Nested;
+	EXPECT_EQ(util::enum_names<Nested>(), (std::array<std::string_view, 2>{"n0", "n1"}));
+}
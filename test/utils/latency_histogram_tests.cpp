@@ -0,0 +1,39 @@
+#include "houdini/util/latency_histogram.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using houdini::util::LatencyHistogram;
+
+TEST(LatencyHistogramTests, bucketsCoverValuesWithBoundedError){
+    for (std::uint64_t value : {0ull, 1ull, 3ull, 4ull, 7ull, 8ull, 100ull, 1000ull, 123456ull, 987654321ull}){
+        const std::size_t bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+        const std::uint64_t upper = LatencyHistogram::upperBound(bucket);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper), 1.25 * static_cast<double>(value) + 1.0);
+        if (bucket > 0){
+            EXPECT_LT(LatencyHistogram::upperBound(bucket - 1), value);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(~0ull), LatencyHistogram::BUCKETS - 1);
+}
+
+TEST(LatencyHistogramTests, percentilesFollowRecordedValues){
+    LatencyHistogram histogram;
+    for (int i = 0; i < 99; i++){
+        histogram.record(100);
+    }
+    histogram.record(10000);
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 100);
+    EXPECT_GE(snapshot.percentile(50), 100);
+    EXPECT_LE(snapshot.percentile(99), 125);
+    EXPECT_GE(snapshot.max(), 10000);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), (99 * 100 + 10000) / 100.0);
+
+    auto scaled = histogram.snapshot(2.0);
+    EXPECT_DOUBLE_EQ(scaled.percentile(50), 2.0 * snapshot.percentile(50));
+    EXPECT_DOUBLE_EQ(LatencyHistogram().snapshot().percentile(99), 0.0);
+}
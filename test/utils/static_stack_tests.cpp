@@ -0,0 +1,68 @@
+#include "houdini/sm/frontend/static_stack.hpp"
+#include "houdini/sm/backend/dispatch_table.hpp"
+#include "houdini/sm/backend/index_defs.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+using houdini::sm::StaticStack;
+
+static_assert(std::is_same_v<houdini::sm::NarrowStateIndex<12>, std::uint8_t>);
+static_assert(std::is_same_v<houdini::sm::NarrowStateIndex<255>, std::uint8_t>);
+static_assert(std::is_same_v<houdini::sm::NarrowStateIndex<256>, std::uint16_t>);
+
+static_assert(std::is_trivially_copyable_v<StaticStack<std::uint8_t, 8>>);
+static_assert(sizeof(StaticStack<std::uint8_t, 8>) == 9);
+//transition record for a state machine of typical depth fits in a cache line
+static_assert(sizeof(houdini::sm::NextState<8, std::uint8_t>) <= 64);
+
+constexpr StaticStack<std::uint8_t, 4> makeStack(){
+    StaticStack<std::uint8_t, 4> stack;
+    stack.push_back(1);
+    stack.push_back(2);
+    stack.push_front(0);
+    return stack;
+}
+
+TEST(StaticStackTests, canBeUsedInConstantExpressions){
+    constexpr auto stack = makeStack();
+    static_assert(stack.size() == 3);
+    static_assert(stack.front() == 0);
+    static_assert(stack.back() == 2);
+}
+
+TEST(StaticStackTests, copiesAreIndependent){
+    StaticStack<std::uint8_t, 4> stack{1, 2, 3};
+    StaticStack<std::uint8_t, 4> copy = stack;
+    copy.pop();
+    copy.push_back(7);
+
+    EXPECT_EQ(stack.size(), 3);
+    EXPECT_EQ(stack.back(), 3);
+    EXPECT_EQ(copy.size(), 3);
+    EXPECT_EQ(copy.back(), 7);
+
+    StaticStack<std::uint8_t, 4> moved = std::move(copy);
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_EQ(moved.back(), 7);
+    
+    stack = moved;
+    EXPECT_EQ(stack.back(), 7);
+}
+
+TEST(StaticStackTests, canBeCopiedWithMemcpy){
+    StaticStack<std::uint8_t, 4> stack{4, 5};
+    StaticStack<std::uint8_t, 4> copy;
+    std::memcpy(&copy, &stack, sizeof(stack));
+
+    ASSERT_EQ(copy.size(), 2);
+    EXPECT_EQ(copy.front(), 4);
+    EXPECT_EQ(copy.back(), 5);
+    int sum = 0;
+    for (auto value:copy){
+        sum += value;
+    }
+    EXPECT_EQ(sum, 9);
+}
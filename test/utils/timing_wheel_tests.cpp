@@ -0,0 +1,150 @@
+#include "houdini/util/timing_wheel.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using houdini::TimePoint;
+using houdini::util::TimerNode;
+using houdini::util::TimingWheel;
+using namespace std::chrono_literals;
+
+namespace {
+//records the tick at which each timer expired in the vector its context points to
+struct Expiry {
+    std::vector<std::pair<std::size_t, std::int64_t>> fired;
+    TimePoint now{};
+};
+
+void record(TimerNode& node){
+    auto& expiry = *static_cast<Expiry*>(node.context);
+    expiry.fired.emplace_back(node.id, std::chrono::duration_cast<std::chrono::milliseconds>(expiry.now.time_since_epoch()).count());
+}
+
+void init(TimerNode& node, Expiry& expiry, std::size_t id){
+    node.callback = &record;
+    node.context = &expiry;
+    node.id = id;
+}
+
+//advance one millisecond at a time, so that the time of each expiry is known
+void runUntil(TimingWheel& wheel, Expiry& expiry, std::chrono::milliseconds end){
+    while (expiry.now < TimePoint{} + end){
+        expiry.now += 1ms;
+        wheel.advance(expiry.now);
+    }
+}
+} //namespace
+
+TEST(TimingWheelTests, timersExpireInOrderAtTheirDelay){
+    TimingWheel wheel;
+    Expiry expiry;
+    wheel.advance(expiry.now);
+    //delays on every level of the wheel
+    const std::vector<std::int64_t> delays = {1, 63, 64, 65, 500, 4095, 4096, 4097, 70000, 300000};
+    std::vector<TimerNode> timers(delays.size());
+    for (std::size_t i = 0; i < delays.size(); i++){
+        init(timers[i], expiry, i);
+    }
+    for (std::size_t i = delays.size(); i-- > 0;){
+        wheel.arm(timers[i], std::chrono::milliseconds(delays[i]));
+    }
+    EXPECT_EQ(wheel.size(), delays.size());
+
+    runUntil(wheel, expiry, 300s);
+    ASSERT_EQ(expiry.fired.size(), delays.size());
+    for (std::size_t i = 0; i < delays.size(); i++){
+        EXPECT_EQ(expiry.fired[i].first, i);
+        EXPECT_EQ(expiry.fired[i].second, delays[i]);
+    }
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTests, cancelledTimersDoNotExpire){
+    TimingWheel wheel;
+    Expiry expiry;
+    wheel.advance(expiry.now);
+    TimerNode first(&record, &expiry, 0);
+    TimerNode second(&record, &expiry, 1);
+    wheel.arm(first, 10ms);
+    wheel.arm(second, 5000ms);
+    wheel.cancel(first);
+    {
+        TimerNode destroyed(&record, &expiry, 2);
+        wheel.arm(destroyed, 20ms);
+    }
+    EXPECT_FALSE(first.armed());
+    EXPECT_EQ(wheel.size(), 1);
+
+    //a timer armed again only expires at its new delay
+    wheel.arm(second, 30ms);
+    wheel.advance(TimePoint{} + 10s);
+    ASSERT_EQ(expiry.fired.size(), 1);
+    EXPECT_EQ(expiry.fired[0].first, 1);
+}
+
+TEST(TimingWheelTests, jumpsOverLongIdlePeriods){
+    TimingWheel wheel;
+    Expiry expiry;
+    wheel.advance(TimePoint{});
+    TimerNode timer(&record, &expiry, 0);
+    //longer than the range of the wheel
+    wheel.arm(timer, 10h);
+    EXPECT_EQ(wheel.advance(TimePoint{} + 10h - 1ms), 0);
+    EXPECT_LE(wheel.nextDue(), TimePoint{} + 10h);
+    EXPECT_EQ(wheel.advance(TimePoint{} + 10h), 1);
+}
+
+TEST(TimingWheelTests, nextDueIsNeverAfterTheEarliestTimer){
+    TimingWheel wheel;
+    Expiry expiry;
+    EXPECT_EQ(wheel.nextDue(), TimePoint::max());
+    TimerNode timer(&record, &expiry, 0);
+    wheel.arm(timer, 300ms);
+    EXPECT_EQ(wheel.nextDue(), TimePoint::min()) << "The wheel should be advanced once to set its time";
+
+    wheel.advance(TimePoint{});
+    //jumping straight to each due time reaches the expiry without passing it
+    std::size_t wakeups = 0;
+    while (!wheel.empty()){
+        const TimePoint due = wheel.nextDue();
+        ASSERT_LE(due, TimePoint{} + 300ms);
+        expiry.now = due;
+        wheel.advance(due);
+        wakeups++;
+    }
+    EXPECT_EQ(expiry.fired.size(), 1);
+    EXPECT_EQ(expiry.fired[0].second, 300);
+    EXPECT_LE(wakeups, 3);
+}
+
+TEST(TimingWheelTests, manyTimersExpireAtTheirDelay){
+    constexpr std::size_t num_timers = 100000;
+    TimingWheel wheel;
+    Expiry expiry;
+    wheel.advance(expiry.now);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int64_t> delay(1, 20000);
+    std::vector<std::int64_t> delays(num_timers);
+    auto timers = std::make_unique<TimerNode[]>(num_timers);
+    for (std::size_t i = 0; i < num_timers; i++){
+        init(timers[i], expiry, i);
+        delays[i] = delay(generator);
+        wheel.arm(timers[i], std::chrono::milliseconds(delays[i]));
+    }
+    //cancel every other timer
+    for (std::size_t i = 0; i < num_timers; i += 2){
+        wheel.cancel(timers[i]);
+    }
+    EXPECT_EQ(wheel.size(), num_timers / 2);
+
+    runUntil(wheel, expiry, 20s);
+    ASSERT_EQ(expiry.fired.size(), num_timers / 2);
+    for (const auto& [id, time]:expiry.fired){
+        EXPECT_EQ(id % 2, 1);
+        EXPECT_EQ(time, delays[id]);
+    }
+}